@@ -1,14 +1,67 @@
 #ifndef CHESS_AI_H
 #define CHESS_AI_H
+#include "compact_move.h"
+#include "search_control.h"
+#include "search_info.h"
+#include "search_limits.h"
+#include "search_stats.h"
+#include "transposition_table.h"
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
 
-class Move;
-class Table;
+class Nnue;
+class OpeningBook;
+class Position;
+class Tablebase;
 
+// The bot. It runs a lazy SMP search: every thread searches the same
+// position and they share the transposition table, which is kept from one
+// bot move to the next.
 class AI {
   public:
-    static Move *minimaxRoot(int depth, Table &table, bool isMax);
-    static int minimax(int depth, Table &table, int alpha, int beta,
-                       bool isMax);
+    using IterationCallback = std::function<void(const SearchInfo &info)>;
+
+  private:
+    TranspositionTable transpositionTable;
+    const int threads{};
+    SearchStats stats;
+    // its moves are played without a search while the game is in it
+    std::unique_ptr<OpeningBook> openingBook;
+    // the endings it holds are probed instead of searched
+    std::unique_ptr<Tablebase> tablebase;
+    // evaluates instead of the tapered evaluation when there is one
+    std::unique_ptr<Nnue> network;
+
+  public:
+    explicit AI(
+        std::size_t hashMegabytes = TranspositionTable::DEFAULT_MEGABYTES,
+        int threads = 0);
+    ~AI();
+    //
+    void setOpeningBook(std::unique_ptr<OpeningBook> openingBook);
+    void setTablebase(std::unique_ptr<Tablebase> tablebase);
+    void setNetwork(std::unique_ptr<Nnue> network);
+    // the book move or else the best move of the main thread for the side
+    // to move, a null move if it has none
+    CompactMove search(const Position &position, const SearchLimits &limits);
+    // The same on a control the caller started, so another thread can stop
+    // the search or end its pondering. The callback runs on the main search
+    // thread after each of its iterations.
+    CompactMove search(const Position &position, const SearchLimits &limits,
+                       SearchControl &control,
+                       const IterationCallback &onIteration = {});
+    // the best move followed by the best moves stored in the transposition
+    // table, as long as they are legal
+    std::vector<CompactMove> getPrincipalVariation(const Position &position,
+                                                   CompactMove bestMove) const;
+    // forgets the transposition table, for a new game
+    void clear();
+    // counters of all threads in the last search
+    const SearchStats &getStats() const;
+    // one thread per hardware thread, used when no thread count is given
+    static int getDefaultThreads();
 };
 
-#endif
\ No newline at end of file
+#endif
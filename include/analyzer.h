@@ -0,0 +1,79 @@
+#ifndef ANALYZER_H
+#define ANALYZER_H
+#include "search_limits.h"
+#include "transposition_table.h"
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+class EpdFile;
+class Tablebase;
+
+// Batch analysis of the records of an EPD file on a work-stealing thread
+// pool. Every worker searches one position at a time with its own
+// transposition table. Results are written as JSON lines in the order of
+// the file, and only a few records per worker are in flight at once, so the
+// memory use does not grow with the file.
+class Analyzer {
+  private:
+    struct Task {
+        // record number in the file, from 0
+        std::size_t index{};
+        // a view into the mapped file
+        std::string_view record;
+    };
+    // the tasks dealt to a worker, it takes them from the front and idle
+    // workers steal from the back
+    struct WorkQueue {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+    struct Result {
+        std::string line;
+        bool isReady{};
+    };
+    static constexpr SearchLimits DEFAULT_LIMITS{.maxDepth = 5};
+    // records in flight per worker, dealt but not yet written
+    static constexpr std::size_t RECORDS_PER_WORKER{4};
+    const SearchLimits limits;
+    const std::size_t hashMegabytes{};
+    // shared by the workers, probing only reads it
+    const Tablebase *tablebase{};
+    std::vector<WorkQueue> queues;
+    // the results not yet written, by record number modulo their count
+    std::vector<Result> results;
+    // guards results, pendingTasks and isFinished
+    std::mutex mutex;
+    std::condition_variable taskAdded;
+    std::condition_variable resultReady;
+    // tasks in the queues not yet claimed by a worker
+    std::size_t pendingTasks{};
+    bool isFinished{};
+    //
+    // claims a task, waits for one while the file is not finished
+    bool takeTask(int worker, Task &task);
+    void work(int worker);
+    // the JSON line of the record
+    std::string analyzeRecord(const Task &task,
+                              TranspositionTable &transpositionTable) const;
+    static std::string escapeJson(std::string_view text);
+
+  public:
+    // the hash size is shared out among the workers
+    Analyzer(int threads, const SearchLimits &limits,
+             std::size_t hashMegabytes, const Tablebase *tablebase = nullptr);
+    //
+    // analyzes every record of the file, returns the number of records
+    std::size_t analyze(EpdFile &epdFile, std::ostream &output);
+    // Chess analyze --input <file> [--output <file>] [--threads <N>]
+    //     [--depth <plies>] [--movetime <ms>] [--nodes <N>] [--hash <MB>]
+    //     [--tablebases <dir>]
+    static int run(const std::vector<std::string> &arguments);
+};
+
+#endif
@@ -0,0 +1,72 @@
+#ifndef ARENA_H
+#define ARENA_H
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <vector>
+
+// Destroys an object of an arena, its memory goes back with the whole arena.
+struct ArenaDeleter {
+    template <typename T> void operator()(T *object) const {
+        std::destroy_at(object);
+    }
+};
+template <typename T> using ArenaPtr = std::unique_ptr<T, ArenaDeleter>;
+
+// A monotonic memory resource for the objects of one turn. Allocation bumps
+// a pointer through a block taken once at construction, deallocation does
+// nothing and release frees everything at once, so a turn that fits in the
+// block never calls malloc. Further blocks come from the heap and are
+// counted, the counters start over with each release.
+class Arena : public std::pmr::memory_resource {
+  public:
+    // the moves of a player's turn with room to spare
+    static constexpr std::size_t DEFAULT_BYTES{16 * 1024};
+
+  private:
+    // the heap behind the arena, counting its allocations
+    class HeapResource : public std::pmr::memory_resource {
+      private:
+        std::size_t allocations{};
+
+        void *do_allocate(std::size_t bytes, std::size_t alignment) override;
+        void do_deallocate(void *pointer, std::size_t bytes,
+                           std::size_t alignment) override;
+        bool do_is_equal(
+            const std::pmr::memory_resource &other) const noexcept override;
+
+      public:
+        std::size_t getAllocations() const;
+        void resetAllocations();
+    };
+    HeapResource heap;
+    std::vector<std::byte> firstBlock;
+    std::pmr::monotonic_buffer_resource buffer;
+    std::size_t allocations{};
+    std::size_t allocatedBytes{};
+    //
+    void *do_allocate(std::size_t bytes, std::size_t alignment) override;
+    void do_deallocate(void *pointer, std::size_t bytes,
+                       std::size_t alignment) override;
+    bool do_is_equal(
+        const std::pmr::memory_resource &other) const noexcept override;
+
+  public:
+    explicit Arena(std::size_t bytes = DEFAULT_BYTES);
+    Arena(const Arena &) = delete;
+    Arena &operator=(const Arena &) = delete;
+    //
+    // frees all the memory, the objects in it must be destroyed before
+    void release();
+    template <typename T, typename... Args> ArenaPtr<T> make(Args &&...args) {
+        return ArenaPtr<T>(
+            std::construct_at(static_cast<T *>(allocate(sizeof(T), alignof(T))),
+                              std::forward<Args>(args)...));
+    }
+    // since the last release
+    std::size_t getAllocations() const;
+    std::size_t getAllocatedBytes() const;
+    std::size_t getHeapAllocations() const;
+};
+
+#endif
@@ -0,0 +1,122 @@
+#ifndef BITBOARD_H
+#define BITBOARD_H
+#include "board_utils.h"
+#include "color.h"
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <vector>
+
+// Bit i is set when the square with coordinate i (a8 = 0, h1 = 63) is
+// occupied, the same numbering as BoardUtils.
+using Bitboard = std::uint64_t;
+
+class BitboardUtils {
+  public:
+    static constexpr Bitboard EMPTY{};
+    static constexpr Bitboard squareBit(int coordinate) {
+        return Bitboard{1} << coordinate;
+    }
+    static constexpr bool isSet(Bitboard bitboard, int coordinate) {
+        return bitboard & squareBit(coordinate);
+    }
+    static constexpr int popCount(Bitboard bitboard) {
+        return std::popcount(bitboard);
+    }
+    static constexpr int lsb(Bitboard bitboard) {
+        return std::countr_zero(bitboard);
+    }
+    static constexpr int popLsb(Bitboard &bitboard) {
+        const int coordinate{lsb(bitboard)};
+        bitboard &= bitboard - 1;
+        return coordinate;
+    }
+    //
+    // attacked squares of a slider on the coordinate, the rays stop on the
+    // first occupied square and include it
+    static Bitboard getBishopAttacks(int coordinate, Bitboard occupancy);
+    static Bitboard getRookAttacks(int coordinate, Bitboard occupancy);
+    static Bitboard getQueenAttacks(int coordinate, Bitboard occupancy);
+    static Bitboard getKnightAttacks(int coordinate);
+    static Bitboard getKingAttacks(int coordinate);
+    // the squares a pawn of the color on the coordinate captures on
+    static Bitboard getPawnAttacks(Color::ColorT color, int coordinate);
+    // the squares strictly between two squares on a common row, column or
+    // diagonal, empty if they are not aligned
+    static Bitboard getBetween(int coordinate, int otherCoordinate);
+    // the whole row, column or diagonal through two squares, empty if they
+    // are not aligned
+    static Bitboard getLine(int coordinate, int otherCoordinate);
+
+  private:
+    // Fancy magic bitboards: the relevant blockers of the ray mask multiplied
+    // by the magic number give a collision free index into the attack table.
+    struct Magic {
+        Bitboard mask{};
+        Bitboard magic{};
+        int offset{};
+        int shift{};
+    };
+    struct MagicTable {
+        std::array<Magic, BoardUtils::NUMBER_SQUARES> magics{};
+        std::vector<Bitboard> attacks;
+    };
+    // row and column steps of each ray
+    using Directions = std::array<std::array<int, 2>, 4>;
+    static constexpr Directions BISHOP_DIRECTIONS{
+        {{-1, -1}, {-1, 1}, {1, -1}, {1, 1}}};
+    static constexpr Directions ROOK_DIRECTIONS{
+        {{-1, 0}, {0, -1}, {0, 1}, {1, 0}}};
+    static const std::array<Bitboard, BoardUtils::NUMBER_SQUARES>
+        BISHOP_MAGICS;
+    static const std::array<Bitboard, BoardUtils::NUMBER_SQUARES> ROOK_MAGICS;
+    static const MagicTable BISHOP_TABLE;
+    static const MagicTable ROOK_TABLE;
+    // row and column steps of a leaper
+    template <std::size_t N> using Steps = std::array<std::array<int, 2>, N>;
+    static constexpr Steps<8> KNIGHT_STEPS{{{-2, -1},
+                                            {-2, 1},
+                                            {-1, -2},
+                                            {-1, 2},
+                                            {1, -2},
+                                            {1, 2},
+                                            {2, -1},
+                                            {2, 1}}};
+    static constexpr Steps<8> KING_STEPS{
+        {{-1, -1}, {-1, 0}, {-1, 1}, {0, -1}, {0, 1}, {1, -1}, {1, 0}, {1, 1}}};
+    // black pawns capture towards higher rows, white pawns towards lower ones
+    static constexpr Steps<2> BLACK_PAWN_STEPS{{{1, -1}, {1, 1}}};
+    static constexpr Steps<2> WHITE_PAWN_STEPS{{{-1, -1}, {-1, 1}}};
+    static const std::array<Bitboard, BoardUtils::NUMBER_SQUARES>
+        KNIGHT_ATTACKS;
+    static const std::array<Bitboard, BoardUtils::NUMBER_SQUARES>
+        KING_ATTACKS;
+    // indexed by color, then coordinate
+    static const std::array<std::array<Bitboard, BoardUtils::NUMBER_SQUARES>,
+                            2>
+        PAWN_ATTACKS;
+    using SquarePairTable =
+        std::array<std::array<Bitboard, BoardUtils::NUMBER_SQUARES>,
+                   BoardUtils::NUMBER_SQUARES>;
+    static const SquarePairTable BETWEEN;
+    static const SquarePairTable LINES;
+    //
+    template <std::size_t N>
+    static std::array<Bitboard, BoardUtils::NUMBER_SQUARES>
+    initLeaperAttacks(const Steps<N> &steps);
+    static Bitboard calculateRay(int coordinate, Bitboard occupancy,
+                                 int rowStep, int columnStep,
+                                 bool excludeEdges);
+    static Bitboard calculateRayAttacks(int coordinate, Bitboard occupancy,
+                                        const Directions &directions,
+                                        bool excludeEdges);
+    // the between table, or the line table if isLine is set
+    static SquarePairTable initSquarePairTable(bool isLine);
+    static MagicTable initMagicTable(
+        const Directions &directions,
+        const std::array<Bitboard, BoardUtils::NUMBER_SQUARES> &magics);
+    static Bitboard getAttacks(const MagicTable &table, int coordinate,
+                               Bitboard occupancy);
+};
+
+#endif
@@ -2,14 +2,17 @@
 #define BOARD_H
 #include "board_utils.h"
 #include "color.h"
+#include "figure_type.h"
+#include "move.h"
+#include "position.h"
 #include <array>
 #include <memory>
-#include <vector>
+#include <span>
+#include <string>
 
 class Figure;
 class King;
 class Pawn;
-class Move;
 
 class Square {
   private:
@@ -24,21 +27,60 @@ class Square {
     int getCoordinate() const;
     Figure *getFigureOnSquare();
     const Figure *getFigureOnSquare() const;
+    bool isSquareOccupied() const;
+
+  private:
+    // figures are placed and taken only through Board, which keeps its
+    // Position in sync
     void setFigureOnSquare(std::unique_ptr<Figure> newFigure);
-    //
     std::unique_ptr<Figure> releaseFigure();
-    bool isSquareOccupied() const;
+    //
+    friend class Board;
+};
+
+// Everything Board::unmakeMove needs to restore the board exactly. Castling
+// rights live in the king's and rooks' first-move flags, the position only
+// mirrors them for its key.
+struct MoveUndo {
+    std::unique_ptr<Figure> capturedFigure;
+    std::unique_ptr<Figure> promotedPawn;
+    Pawn *enPassantPawn{};
+    int castlingRights{};
+    int halfmoveClock{};
+    bool firstMove{};
+    bool rookFirstMove{};
 };
 
 class Board {
   private:
+    // the figures of one color and type in no particular order, with room
+    // for a board set up with more than a game allows
+    struct FigureList {
+        std::array<Figure *, BoardUtils::NUMBER_SQUARES> figures{};
+        int size{};
+    };
     std::array<std::unique_ptr<Square>, BoardUtils::NUMBER_SQUARES> board;
+    // by color, then by figure type
+    std::array<std::array<FigureList, Position::NUMBER_FIGURE_TYPES>,
+               Position::NUMBER_COLORS>
+        figureLists{};
+    // the index of the figure on each square in its list
+    std::array<int, BoardUtils::NUMBER_SQUARES> listIndices{};
+    Position position;
     Pawn *enPassantPawn{};
     //
-    void setFigureOnBoard(std::unique_ptr<Figure> figure);
+    // derives the castling rights of the position from the first-move flags
+    // of the kings and rooks on their initial squares
+    void updateCastlingRights();
+    FigureList &getFigureList(const Figure &figure);
+    void addToFigureList(Figure *figure, int coordinate);
+    // the last figure of the list takes the place of the removed one
+    void removeFromFigureList(const Figure &figure, int coordinate);
 
   public:
     explicit Board();
+    // throws std::invalid_argument for a malformed FEN string
+    explicit Board(const std::string &fen);
     Board(const Board &board);
     ~Board() = default;
     //
@@ -46,15 +88,28 @@ class Board {
     Pawn *getEnPassantPawn();
     Board &operator=(Board &&board) noexcept;
     //
-    std::vector<Figure *> getActiveFigures();
-    std::vector<Figure *> getActiveFigures(Color::ColorT color);
+    static std::unique_ptr<Figure>
+    createFigure(FigureType figureType, Color::ColorT color, int coordinate);
+    const Position &getPosition() const;
+    void setFigureOnBoard(std::unique_ptr<Figure> figure);
+    std::unique_ptr<Figure> removeFigure(int coordinate);
+    void moveFigure(int coordinate, int coordinateToMove);
+    //
+    // valid until a figure is placed on the board or removed from it
+    std::span<Figure *const> getFigures(Color::ColorT color,
+                                        FigureType figureType) const;
     Square *getSquare(int coordinate);
     const Square *getSquare(int coordinate) const;
-    std::vector<std::unique_ptr<Move>>
-    calculateLegalMoves(Color::ColorT playerColor);
+    MoveUndo makeMove(const Move &move);
+    void unmakeMove(const Move &move, MoveUndo &undo);
+    // the moves of the player's figures, made in the arena like the list
+    MoveVector calculateLegalMoves(Color::ColorT playerColor, Arena &arena);
+    // the first king of the color, nullptr without one
     King *getKing(Color::ColorT color);
+    // answered from the attack tables, no moves are generated
+    bool isSquareAttacked(int coordinate, Color::ColorT byColor) const;
+    Bitboard attackersTo(int coordinate) const;
     void printBoard() const;
-    int evaluateBoard();
 };
 
 #endif
\ No newline at end of file
@@ -1,8 +1,8 @@
 #ifndef BOARD_UTILS_H
 #define BOARD_UTILS_H
 #include <array>
-#include <map>
 #include <string>
+#include <string_view>
 
 class BoardUtils {
   public:
@@ -20,16 +20,17 @@ class BoardUtils {
     static const std::array<bool, NUMBER_SQUARES> SECOND_COLUMN;
     static const std::array<bool, NUMBER_SQUARES> SEVENTH_COLUMN;
     static const std::array<bool, NUMBER_SQUARES> EIGHT_COLUMN;
-    static int getCoordinateAtPosition(const std::string &position);
+    // throws std::out_of_range for anything but a square like "e4"
+    static int getCoordinateAtPosition(std::string_view position);
+    // the coordinate of a square like "e4", -1 for anything else
+    static int parseCoordinate(std::string_view position);
     static std::string getPositionAtCoordinate(int coordinate);
     static bool isValidSquareCoordinate(int coordinate);
 
   private:
     static const std::array<std::string, NUMBER_SQUARES> ALGEBRAIC_NOTATION;
-    static const std::map<std::string, int> POSITION_TO_COORDINATE;
     static std::array<bool, NUMBER_SQUARES> initRow(int rowNumber);
     static std::array<bool, NUMBER_SQUARES> initColumn(int colNumber);
-    static std::map<std::string, int> initializePositionToCoordinate();
 };
 
 #endif
\ No newline at end of file
@@ -1,13 +1,23 @@
 #ifndef CLI_H
 #define CLI_H
+#include "compact_move.h"
+#include "figure_type.h"
+#include "position.h"
+#include "search_control.h"
+#include "search_limits.h"
+#include "transposition_table.h"
 #include <memory>
+#include <thread>
 
+class AI;
 class Board;
 class Player;
 class WhitePlayer;
 class BlackPlayer;
 class Move;
-class Figure;
+class OpeningBook;
+class Nnue;
+class Tablebase;
 
 enum class GameMode {
     PLAYERS = 1,
@@ -19,20 +29,46 @@ class Table {
     std::unique_ptr<Board> board{std::make_unique<Board>()};
     std::unique_ptr<WhitePlayer> whitePlayer;
     std::unique_ptr<BlackPlayer> blackPlayer;
+    // the bot answers within these limits
+    static constexpr SearchLimits EASY_LIMITS{.maxDepth = 1};
+    static constexpr SearchLimits NORMAL_LIMITS{
+        .maxTime = std::chrono::milliseconds{2000}};
     GameMode gameMode{};
-    int difficulty{};
+    SearchLimits searchLimits{NORMAL_LIMITS};
+    // the bot of the game
+    std::unique_ptr<AI> ai;
+    // while the human thinks, the bot searches the position after the reply
+    // it expects to its move
+    SearchControl ponderControl;
+    Position ponderPosition;
+    CompactMove ponderMove;
+    std::jthread ponderer;
     //
     void setGameMode();
     void setPlayers();
     void setDifficulty();
     Move *getPlayerTurn(Player *currentPlayer);
-    std::unique_ptr<Figure> getPromoteFigure(const Move *move) const;
+    FigureType getPromoteFigureType() const;
+    // the allocations of the last calculation of both players' legal moves
+    void printAllocations() const;
     Player *getOpponent(const Player *player);
+    // the bot move in the position of the board
+    CompactMove searchBotMove();
+    // ponders the second move of the principal variation of the bot move,
+    // the board is the position after the bot move
+    void startPondering(const Position &rootPosition, CompactMove bestMove);
+    void stopPondering();
 
   public:
-    Table();
-    Table(const Table &table);
-    ~Table() = default;
+    // zero threads runs one search thread per hardware thread, the bot plays
+    // from the opening book, probes the tablebase and evaluates with the
+    // network if there are any
+    explicit Table(
+        std::size_t hashMegabytes = TranspositionTable::DEFAULT_MEGABYTES,
+        int threads = 0, std::unique_ptr<OpeningBook> openingBook = {},
+        std::unique_ptr<Tablebase> tablebase = {},
+        std::unique_ptr<Nnue> network = {});
+    ~Table();
     //
     Board *getBoard();
     const Board *getBoard() const;
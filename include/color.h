@@ -18,6 +18,14 @@ class Color {
                 return "w";
         }
     };
+    static ColorT getOppositeColor(ColorT color) {
+        switch (color) {
+            case ColorT::BLACK:
+                return ColorT::WHITE;
+            case ColorT::WHITE:
+                return ColorT::BLACK;
+        }
+    }
     static int getDirection(ColorT color) {
         switch (color) {
             case ColorT::BLACK:
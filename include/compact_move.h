@@ -0,0 +1,94 @@
+#ifndef COMPACT_MOVE_H
+#define COMPACT_MOVE_H
+#include "board_utils.h"
+#include "figure_type.h"
+#include <cstdint>
+#include <string>
+#include <type_traits>
+
+// Move packed into 16 bits: coordinate from (bits 0-5), coordinate to move
+// (bits 6-11), flag (bits 12-13) and promotion figure (bits 14-15). It holds
+// no pointers, so it stays valid across board copies and two moves are
+// compared as integers.
+class CompactMove {
+  public:
+    enum class Flag : std::uint8_t {
+        NORMAL,
+        PROMOTION,
+        EN_PASSANT,
+        CASTLING
+    };
+
+  private:
+    static constexpr int COORDINATE_BITS{6};
+    static constexpr std::uint16_t COORDINATE_MASK{0x3F};
+    static constexpr int FLAG_SHIFT{12};
+    static constexpr int PROMOTION_SHIFT{14};
+    std::uint16_t data{};
+
+  public:
+    constexpr CompactMove() = default;
+    constexpr CompactMove(int coordinateFrom, int coordinateToMove,
+                          Flag flag = Flag::NORMAL,
+                          FigureType promotionType = FigureType::QUEEN)
+        : data(static_cast<std::uint16_t>(
+              coordinateFrom | coordinateToMove << COORDINATE_BITS |
+              static_cast<int>(flag) << FLAG_SHIFT |
+              (static_cast<int>(promotionType) -
+               static_cast<int>(FigureType::QUEEN))
+                  << PROMOTION_SHIFT)) {
+    }
+    //
+    constexpr int getCoordinateFrom() const {
+        return data & COORDINATE_MASK;
+    }
+    constexpr int getCoordinateToMove() const {
+        return data >> COORDINATE_BITS & COORDINATE_MASK;
+    }
+    constexpr Flag getFlag() const {
+        return static_cast<Flag>(data >> FLAG_SHIFT & 0x3);
+    }
+    // QUEEN, ROOK, KNIGHT or BISHOP, meaningful for PROMOTION only
+    constexpr FigureType getPromotionType() const {
+        return static_cast<FigureType>((data >> PROMOTION_SHIFT) +
+                                       static_cast<int>(FigureType::QUEEN));
+    }
+    constexpr std::uint16_t getData() const {
+        return data;
+    }
+    // a8a8 can never be played, so the zero value marks "no move"
+    constexpr bool isNull() const {
+        return !data;
+    }
+    // the inverse of getData
+    static constexpr CompactMove fromData(std::uint16_t data) {
+        CompactMove move;
+        move.data = data;
+        return move;
+    }
+    constexpr bool operator==(const CompactMove &other) const = default;
+    //
+    // coordinate notation, e.g. "e2e4" or "e7e8q"
+    std::string toString() const {
+        std::string name{
+            BoardUtils::getPositionAtCoordinate(getCoordinateFrom()) +
+            BoardUtils::getPositionAtCoordinate(getCoordinateToMove())};
+        if (getFlag() != Flag::PROMOTION)
+            return name;
+        switch (getPromotionType()) {
+            case FigureType::ROOK:
+                return name + "r";
+            case FigureType::BISHOP:
+                return name + "b";
+            case FigureType::KNIGHT:
+                return name + "n";
+            default:
+                return name + "q";
+        }
+    }
+};
+
+static_assert(sizeof(CompactMove) == 2);
+static_assert(std::is_trivially_copyable_v<CompactMove>);
+
+#endif
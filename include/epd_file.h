@@ -0,0 +1,38 @@
+#ifndef EPD_FILE_H
+#define EPD_FILE_H
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+// A file of EPD or FEN records mapped into memory, one record per line.
+// Lines are handed out as views into the mapping, nothing is copied and the
+// kernel reads the pages ahead, so the memory use does not grow with the
+// file.
+class EpdFile {
+  private:
+    // the pages of the lines read are dropped from memory in steps of it
+    static constexpr std::size_t RELEASE_SIZE{64 * 1024 * 1024};
+    const char *data{};
+    std::size_t size{};
+    // start of the next unread line
+    std::size_t offset{};
+    std::size_t releasedSize{};
+    //
+    // Drops the pages before the offset. They are reread from the file if a
+    // line on them is still used, so views handed out stay valid.
+    void releaseReadPages();
+
+  public:
+    // throws std::runtime_error when the file cannot be opened or mapped
+    explicit EpdFile(const std::string &path);
+    EpdFile(const EpdFile &epdFile) = delete;
+    EpdFile &operator=(const EpdFile &epdFile) = delete;
+    ~EpdFile();
+    //
+    // the next line that is neither blank nor a # comment, without the line
+    // break, false at the end of the file
+    bool nextLine(std::string_view &line);
+    std::size_t getSize() const;
+};
+
+#endif
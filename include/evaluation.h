@@ -0,0 +1,191 @@
+#ifndef EVALUATION_H
+#define EVALUATION_H
+#include "bitboard.h"
+#include "board_utils.h"
+#include "color.h"
+#include "figure_type.h"
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <vector>
+
+class Position;
+
+// A direct mapped cache of evaluation terms by key. Each search thread owns
+// its tables, so they need no locking. A new entry holds key 0 and no terms,
+// which are the right terms for key 0.
+template <typename Entry> class EvaluationTable {
+  private:
+    std::vector<Entry> entries;
+    std::uint64_t probes{};
+    std::uint64_t hits{};
+
+  public:
+    // the number of entries is rounded down to a power of two
+    explicit EvaluationTable(std::size_t numberEntries)
+        : entries(std::bit_floor(std::max<std::size_t>(numberEntries, 1))) {
+    }
+    //
+    // the entry of the key, found tells whether it holds the terms of the
+    // key or is to be filled with them
+    Entry &probe(std::uint64_t key, bool &found) {
+        Entry &entry{entries[key & (entries.size() - 1)]};
+        found = entry.key == key;
+        probes++;
+        hits += found;
+        return entry;
+    }
+    std::uint64_t getProbes() const {
+        return probes;
+    }
+    std::uint64_t getHits() const {
+        return hits;
+    }
+};
+
+// Pawn structure terms by pawn key. The pawns move in few of the moves, so
+// most evaluations find their skeleton here instead of scanning it.
+struct PawnEntry {
+    static constexpr std::size_t DEFAULT_ENTRIES{1 << 14};
+    std::uint64_t key{};
+    // white's passed, isolated, doubled and backward pawn terms minus
+    // black's
+    std::int16_t middlegameScore{};
+    std::int16_t endgameScore{};
+    // the shelter of each king, by color, is kept for the square it was
+    // computed on, -1 for none
+    std::array<std::int8_t, 2> shelterCoordinates{-1, -1};
+    std::array<std::int16_t, 2> shelterScores{};
+};
+using PawnTable = EvaluationTable<PawnEntry>;
+
+// Material imbalance terms by material key, the key of the figure counts.
+struct MaterialEntry {
+    static constexpr std::size_t DEFAULT_ENTRIES{1 << 12};
+    std::uint64_t key{};
+    // white's terms minus black's
+    std::int16_t middlegameScore{};
+    std::int16_t endgameScore{};
+};
+using MaterialTable = EvaluationTable<MaterialEntry>;
+
+// Tapered evaluation in centipawns. Every figure scores its material and a
+// bonus for its square twice, once for the middlegame and once for the
+// endgame. The position keeps both sums up to date on every move, like its
+// key, together with the game phase that blends them: 24 with all the
+// figures on the board, down to 0 with kings and pawns only. The values are
+// those of PeSTO, from white's point of view with a8 first; black reads them
+// on the square mirrored by rows. The pawn structure, the king shelter and
+// the material imbalance come from the tables and are only computed when
+// their key is missing.
+class Evaluation {
+  public:
+    // the phase of the starting position
+    static constexpr int MAX_PHASE{24};
+    // the figure values of Position count in pawns
+    static constexpr int CENTIPAWNS_PER_PAWN{100};
+
+  private:
+    static constexpr int NUMBER_FIGURE_TYPES{6};
+    static constexpr int NUMBER_ROWS{BoardUtils::NUMBER_SQUARE_PER_ROW};
+    using SquareTables =
+        std::array<std::array<int, BoardUtils::NUMBER_SQUARES>,
+                   NUMBER_FIGURE_TYPES>;
+    // white values positive, black ones negative, by color * number of
+    // figure types + figure type
+    using ValueTables =
+        std::array<std::array<int, BoardUtils::NUMBER_SQUARES>,
+                   2 * NUMBER_FIGURE_TYPES>;
+    // by color and square
+    using PawnMasks =
+        std::array<std::array<Bitboard, BoardUtils::NUMBER_SQUARES>, 2>;
+    // by figure type
+    static constexpr std::array<int, NUMBER_FIGURE_TYPES> MIDDLEGAME_MATERIAL{
+        0, 1025, 477, 337, 365, 82};
+    static constexpr std::array<int, NUMBER_FIGURE_TYPES> ENDGAME_MATERIAL{
+        0, 936, 512, 281, 297, 94};
+    static constexpr std::array<int, NUMBER_FIGURE_TYPES> PHASE_WEIGHTS{
+        0, 4, 2, 1, 1, 0};
+    // passed pawns by the rank seen from their side, the first is 0
+    static constexpr std::array<int, NUMBER_ROWS> PASSED_MIDDLEGAME{
+        0, 5, 10, 15, 25, 40, 65, 0};
+    static constexpr std::array<int, NUMBER_ROWS> PASSED_ENDGAME{
+        0, 10, 15, 25, 45, 75, 120, 0};
+    // no pawn of the side on the neighbour files
+    static constexpr int ISOLATED_MIDDLEGAME{-10};
+    static constexpr int ISOLATED_ENDGAME{-15};
+    // per pawn behind another of the side on the file
+    static constexpr int DOUBLED_MIDDLEGAME{-10};
+    static constexpr int DOUBLED_ENDGAME{-20};
+    // no pawn of the side can come beside it and an enemy pawn guards the
+    // square in front of it
+    static constexpr int BACKWARD_MIDDLEGAME{-8};
+    static constexpr int BACKWARD_ENDGAME{-10};
+    // middlegame only, per file of the king and its neighbours without a
+    // pawn of the side one or two rows in front of the king
+    static constexpr int SHELTER_SECOND_ROW{-10};
+    static constexpr int SHELTER_MISSING{-25};
+    static constexpr int BISHOP_PAIR_MIDDLEGAME{30};
+    static constexpr int BISHOP_PAIR_ENDGAME{50};
+    // per own pawn more than five: knights gain with a closed board, rooks
+    // lose
+    static constexpr int KNIGHT_PAWN_BONUS{6};
+    static constexpr int ROOK_PAWN_BONUS{-12};
+    static constexpr int BASE_PAWNS{5};
+    static const SquareTables MIDDLEGAME_SQUARES;
+    static const SquareTables ENDGAME_SQUARES;
+    static const ValueTables MIDDLEGAME_VALUES;
+    static const ValueTables ENDGAME_VALUES;
+    static const std::array<Bitboard, NUMBER_ROWS> FILE_MASKS;
+    // the squares ahead on the file and its neighbours, which enemy pawns
+    // must leave free for a passed pawn
+    static const PawnMasks PASSED_MASKS;
+    // the neighbour files from the row back to the side's first row, where
+    // pawns of the side may support the pawn
+    static const PawnMasks SUPPORT_MASKS;
+    //
+    static ValueTables
+    initValues(const std::array<int, NUMBER_FIGURE_TYPES> &material,
+               const SquareTables &squares);
+    static std::array<Bitboard, NUMBER_ROWS> initFileMasks();
+    // ahead selects the rows in front of the square, else the row and the
+    // ones behind it
+    static PawnMasks initPawnMasks(bool ahead, bool sameFile);
+    static int getTableIndex(FigureType figureType, Color::ColorT color) {
+        return static_cast<int>(color) * NUMBER_FIGURE_TYPES +
+               static_cast<int>(figureType);
+    }
+    // the terms of the side's pawns, added to the scores
+    static void addPawnTerms(const Position &position, Color::ColorT color,
+                             int &middlegameScore, int &endgameScore);
+    static int getShelter(const Position &position, Color::ColorT color,
+                          int kingCoordinate);
+    static void addMaterialTerms(const Position &position,
+                                 Color::ColorT color, int &middlegameScore,
+                                 int &endgameScore);
+    static void fillPawnEntry(const Position &position, PawnEntry &entry);
+    static void fillMaterialEntry(const Position &position,
+                                  MaterialEntry &entry);
+
+  public:
+    static int getMiddlegameValue(FigureType figureType, Color::ColorT color,
+                                  int coordinate) {
+        return MIDDLEGAME_VALUES[getTableIndex(figureType, color)][coordinate];
+    }
+    static int getEndgameValue(FigureType figureType, Color::ColorT color,
+                               int coordinate) {
+        return ENDGAME_VALUES[getTableIndex(figureType, color)][coordinate];
+    }
+    static int getPhaseWeight(FigureType figureType) {
+        return PHASE_WEIGHTS[static_cast<int>(figureType)];
+    }
+    // from white's point of view
+    static int getScore(const Position &position, PawnTable &pawnTable,
+                        MaterialTable &materialTable);
+    // from the side to move's point of view
+    static int evaluate(const Position &position, PawnTable &pawnTable,
+                        MaterialTable &materialTable);
+};
+
+#endif
@@ -0,0 +1,55 @@
+#ifndef FEN_H
+#define FEN_H
+#include "color.h"
+#include "figure_type.h"
+#include "position.h"
+#include <string>
+#include <string_view>
+
+// Forsyth-Edwards notation of a Position and the EPD records built on it.
+// Parsing fills a position of the caller and allocates nothing unless the
+// record is malformed, so bulk loading costs only the scan of the text.
+class Fen {
+  public:
+    static constexpr std::string_view START_POSITION{
+        "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1"};
+
+  private:
+    // figure symbols of white by figure type, black uses the lower case
+    static constexpr std::string_view FIGURE_SYMBOLS{"KQRNBP"};
+    // in the order of the castling rights bits
+    static constexpr std::string_view CASTLING_SYMBOLS{"KQkq"};
+    //
+    // the next field separated by spaces, removed from the record
+    static std::string_view nextField(std::string_view &record);
+    static bool parseNumber(std::string_view field, int &number);
+    // the first four fields, shared by FEN and EPD, false if malformed
+    static bool parsePosition(std::string_view &record, Position &position);
+    static bool parsePlacement(std::string_view placement,
+                               Position &position);
+    static bool parseCastlingRights(std::string_view castling,
+                                    Position &position);
+    static bool parseEnPassant(std::string_view enPassant,
+                               Position &position);
+    // one king per color and no pawns on the first or eighth rank
+    static bool isValid(const Position &position);
+    static char getFigureSymbol(FigureType figureType, Color::ColorT color);
+
+  public:
+    // Throws std::invalid_argument for a malformed record. The halfmove
+    // clock and the fullmove number may be left out, castling rights
+    // without their king and rook and an en passant square without a pawn
+    // to capture are dropped.
+    static void parse(std::string_view fen, Position &position);
+    // The four position fields of an EPD record, then either the two clocks
+    // of a FEN or the hmvc and fmvn operations. Returns the operations, for
+    // getOperation. Throws std::invalid_argument like parse.
+    static std::string_view parseEpd(std::string_view epd, Position &position);
+    // the operand of the first operation with the opcode, unquoted, empty if
+    // there is none
+    static std::string_view getOperation(std::string_view operations,
+                                         std::string_view opcode);
+    static std::string write(const Position &position);
+};
+
+#endif
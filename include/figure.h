@@ -1,11 +1,11 @@
 #ifndef FIGURE_H
 #define FIGURE_H
+#include "bitboard.h"
 #include "color.h"
+#include "figure_type.h"
+#include "move.h"
 #include <memory>
-#include <vector>
 
-enum class FigureType;
-class Move;
 class Board;
 class Player;
 
@@ -16,6 +16,10 @@ class Figure {
     bool firstMove{true};
     FigureType figureType;
     int value{};
+    //
+    // quiet and attack moves to the attacked squares of a slider
+    void calculateSlidingMoves(Board &board, Bitboard attacks, Arena &arena,
+                               MoveVector &legalMoves) const;
 
   public:
     explicit Figure(int coordinate, Color::ColorT color, FigureType figureType,
@@ -28,11 +32,14 @@ class Figure {
     Color::ColorT getColor() const;
     int getValue() const;
     //
-    virtual std::vector<std::unique_ptr<Move>>
-    calculateLegalMoves(Board &board) const = 0;
+    // appends the moves, made in the arena, to the list
+    virtual void calculateLegalMoves(Board &board, Arena &arena,
+                                     MoveVector &legalMoves) const = 0;
     void
     move(int coordinate, Board &board);
+    void undoMove(int coordinate, Board &board, bool firstMove);
     bool isFirstMove() const;
+    void setFirstMove(bool firstMove);
     virtual std::string getFigureName() const = 0;
     virtual std::unique_ptr<Figure> clone() const = 0;
     virtual bool equals(const Figure &other) const;
@@ -54,8 +61,8 @@ class King : public Figure {
     King(const King &king) = default;
     ~King() override = default;
     //
-    std::vector<std::unique_ptr<Move>>
-    calculateLegalMoves(Board &board) const override;
+    void calculateLegalMoves(Board &board, Arena &arena,
+                             MoveVector &legalMoves) const override;
     bool isCastled() const;
     bool isInCheck() const;
     std::string getFigureName() const override;
@@ -66,40 +73,25 @@ class King : public Figure {
 };
 
 class Queen : public Figure {
-  private:
-    static constexpr int CANDIDATE_MOVE_VECTOR_COORDINATES[]{-9, -8, -7, -1,
-                                                             1,  7,  8,  9};
-    static bool isFirstColumnExclusion(int currentPosition,
-                                       int candidateOffset);
-    static bool isEightColumnExclusion(int currentPosition,
-                                       int candidateOffset);
-
   public:
     explicit Queen(int coordinate, Color::ColorT color);
     Queen(const Queen &queen) = default;
     ~Queen() override = default;
     //
-    std::vector<std::unique_ptr<Move>>
-    calculateLegalMoves(Board &board) const override;
+    void calculateLegalMoves(Board &board, Arena &arena,
+                             MoveVector &legalMoves) const override;
     std::string getFigureName() const override;
     std::unique_ptr<Figure> clone() const override;
 };
 
 class Rook : public Figure {
-  private:
-    static constexpr int CANDIDATE_MOVE_VECTOR_COORDINATES[]{-8, -1, 1, 8};
-    static bool isFirstColumnExclusion(int currentPosition,
-                                       int candidateOffset);
-    static bool isEightColumnExclusion(int currentPosition,
-                                       int candidateOffset);
-
   public:
     explicit Rook(int coordinate, Color::ColorT color);
     Rook(const Rook &rook) = default;
     ~Rook() override = default;
     //
-    std::vector<std::unique_ptr<Move>>
-    calculateLegalMoves(Board &board) const override;
+    void calculateLegalMoves(Board &board, Arena &arena,
+                             MoveVector &legalMoves) const override;
     std::string getFigureName() const override;
     std::unique_ptr<Figure> clone() const override;
 };
@@ -122,27 +114,20 @@ class Knight : public Figure {
     Knight(const Knight &knight) = default;
     ~Knight() override = default;
     //
-    std::vector<std::unique_ptr<Move>>
-    calculateLegalMoves(Board &board) const override;
+    void calculateLegalMoves(Board &board, Arena &arena,
+                             MoveVector &legalMoves) const override;
     std::string getFigureName() const override;
     std::unique_ptr<Figure> clone() const override;
 };
 
 class Bishop : public Figure {
-  private:
-    static constexpr int CANDIDATE_MOVE_VECTOR_COORDINATES[]{-9, -7, 7, 9};
-    static bool isFirstColumnExclusion(int currentPosition,
-                                       int candidateOffset);
-    static bool isEightColumnExclusion(int currentPosition,
-                                       int candidateOffset);
-
   public:
     explicit Bishop(int coordinate, Color::ColorT color);
     Bishop(const Bishop &bishop) = default;
     ~Bishop() override = default;
     //
-    std::vector<std::unique_ptr<Move>>
-    calculateLegalMoves(Board &board) const override;
+    void calculateLegalMoves(Board &board, Arena &arena,
+                             MoveVector &legalMoves) const override;
     std::string getFigureName() const override;
     std::unique_ptr<Figure> clone() const override;
 };
@@ -150,15 +135,20 @@ class Bishop : public Figure {
 class Pawn : public Figure {
   private:
     static constexpr int CANDIDATE_MOVE_COORDINATES[]{8, 16, 7, 9};
+    static constexpr FigureType PROMOTION_FIGURE_TYPES[]{
+        FigureType::QUEEN, FigureType::ROOK, FigureType::BISHOP,
+        FigureType::KNIGHT};
     bool isHasEnPassantMove(Board &board, int enPassantCoordinate) const;
+    static void addPromotionMoves(Arena &arena, MoveVector &legalMoves,
+                                  const Move &move);
 
   public:
     explicit Pawn(int coordinate, Color::ColorT color);
     Pawn(const Pawn &pawn) = default;
     ~Pawn() override = default;
     //
-    std::vector<std::unique_ptr<Move>>
-    calculateLegalMoves(Board &board) const override;
+    void calculateLegalMoves(Board &board, Arena &arena,
+                             MoveVector &legalMoves) const override;
     std::string getFigureName() const override;
     std::unique_ptr<Figure> clone() const override;
 };
@@ -1,13 +1,25 @@
 #ifndef MOVE_H
 #define MOVE_H
-#include <memory>
+#include "arena.h"
+#include "compact_move.h"
+#include "figure_type.h"
+#include <memory_resource>
+#include <vector>
 
 class Figure;
 class Board;
+class Move;
+struct MoveUndo;
+
+// The moves of a turn live in an arena, the list of a player is released
+// with it when the player's next moves are calculated.
+using MovePtr = ArenaPtr<Move>;
+using MoveVector = std::pmr::vector<MovePtr>;
 
 class Move {
   protected:
     const Figure *movedFigure{};
+    const int coordinateFrom{};
     const int coordinateToMove{};
     //
     Move() = default;
@@ -17,12 +29,17 @@ class Move {
     Move(const Move &move) = default;
     virtual ~Move() = default;
     //
+    int getCoordinateFrom() const;
     int getCoordinateToMove() const;
     const Figure *getMovedFigure() const;
     //
-    virtual std::unique_ptr<Board> execute(Board &board) const = 0;
-    virtual std::unique_ptr<Move> clone() const = 0;
-    virtual bool equals(const Move &other) const;
+    // called by Board::makeMove and Board::unmakeMove, the figures are looked
+    // up by coordinate on the given board
+    virtual void make(Board &board, MoveUndo &undo) const;
+    virtual void unmake(Board &board, MoveUndo &undo) const;
+    virtual MovePtr clone(Arena &arena) const = 0;
+    virtual CompactMove toCompactMove() const;
+    bool equals(const Move &other) const;
 };
 
 class MajorMove : public Move {
@@ -31,8 +48,7 @@ class MajorMove : public Move {
     MajorMove() = delete;
     ~MajorMove() override = default;
     //
-    std::unique_ptr<Board> execute(Board &board) const override;
-    std::unique_ptr<Move> clone() const override;
+    MovePtr clone(Arena &arena) const override;
 };
 
 class AttackMove : public Move {
@@ -48,9 +64,9 @@ class AttackMove : public Move {
     //
     const Figure *getAttackFigure() const;
     //
-    std::unique_ptr<Board> execute(Board &board) const override = 0;
-    std::unique_ptr<Move> clone() const override = 0;
-    bool equals(const Move &other) const override;
+    void make(Board &board, MoveUndo &undo) const override;
+    void unmake(Board &board, MoveUndo &undo) const override;
+    MovePtr clone(Arena &arena) const override = 0;
 };
 
 class MajorAttackMove : public AttackMove {
@@ -58,8 +74,7 @@ class MajorAttackMove : public AttackMove {
     using AttackMove::AttackMove;
     ~MajorAttackMove() override = default;
     //
-    std::unique_ptr<Board> execute(Board &board) const override;
-    std::unique_ptr<Move> clone() const override;
+    MovePtr clone(Arena &arena) const override;
 };
 
 class PawnAttackMove : public AttackMove {
@@ -67,8 +82,7 @@ class PawnAttackMove : public AttackMove {
     using AttackMove::AttackMove;
     ~PawnAttackMove() override = default;
     //
-    std::unique_ptr<Board> execute(Board &board) const override;
-    std::unique_ptr<Move> clone() const override;
+    MovePtr clone(Arena &arena) const override;
 };
 
 class PawnEnPassantAttackMove : public PawnAttackMove {
@@ -78,8 +92,8 @@ class PawnEnPassantAttackMove : public PawnAttackMove {
                                      int coordinateToMove);
     ~PawnEnPassantAttackMove() override = default;
     //
-    std::unique_ptr<Board> execute(Board &board) const override;
-    std::unique_ptr<Move> clone() const override;
+    MovePtr clone(Arena &arena) const override;
+    CompactMove toCompactMove() const override;
 };
 
 class PawnMove : public Move {
@@ -88,8 +102,7 @@ class PawnMove : public Move {
     PawnMove() = delete;
     ~PawnMove() override = default;
     //
-    std::unique_ptr<Board> execute(Board &board) const override;
-    std::unique_ptr<Move> clone() const override;
+    MovePtr clone(Arena &arena) const override;
 };
 
 class PawnJump : public Move {
@@ -98,30 +111,36 @@ class PawnJump : public Move {
     PawnJump() = delete;
     ~PawnJump() override = default;
     //
-    std::unique_ptr<Board> execute(Board &board) const override;
-    std::unique_ptr<Move> clone() const override;
+    void make(Board &board, MoveUndo &undo) const override;
+    MovePtr clone(Arena &arena) const override;
 };
 
+// The promoted figure is only created when the move is made, so the four
+// promotions of a pawn cost no figures while they are merely legal.
 class PawnPromotion : public Move {
   private:
-    std::unique_ptr<Figure> promotionFigure;
-    std::unique_ptr<Move> decoratedMove;
+    FigureType promotionType{};
+    MovePtr decoratedMove;
 
   public:
-    explicit PawnPromotion(std::unique_ptr<Move> decoratedMove);
-    PawnPromotion(const PawnPromotion &pawnPromotion);
+    explicit PawnPromotion(MovePtr decoratedMove,
+                           FigureType promotionType = FigureType::QUEEN);
+    PawnPromotion(const PawnPromotion &pawnPromotion) = delete;
     ~PawnPromotion() override = default;
     //
-    void setPromotionFigure(std::unique_ptr<Figure> figure);
+    FigureType getPromotionType() const;
+    void setPromotionType(FigureType promotionType);
     //
-    std::unique_ptr<Board> execute(Board &board) const override;
-    std::unique_ptr<Move> clone() const override;
-    bool equals(const Move &other) const override;
+    void make(Board &board, MoveUndo &undo) const override;
+    void unmake(Board &board, MoveUndo &undo) const override;
+    MovePtr clone(Arena &arena) const override;
+    CompactMove toCompactMove() const override;
 };
 
 class CastleMove : public Move {
   private:
     const Figure *rook{};
+    const int rookCoordinate{};
     const int rookDestinationCoordinate{};
 
   public:
@@ -130,9 +149,10 @@ class CastleMove : public Move {
     CastleMove(const CastleMove &castleMove) = default;
     ~CastleMove() override = default;
     //
-    std::unique_ptr<Board> execute(Board &board) const override = 0;
-    std::unique_ptr<Move> clone() const override = 0;
-    bool equals(const Move &other) const override;
+    void make(Board &board, MoveUndo &undo) const override;
+    void unmake(Board &board, MoveUndo &undo) const override;
+    MovePtr clone(Arena &arena) const override = 0;
+    CompactMove toCompactMove() const override;
 };
 
 class KingSideCastleMove : public CastleMove {
@@ -140,8 +160,7 @@ class KingSideCastleMove : public CastleMove {
     using CastleMove::CastleMove;
     ~KingSideCastleMove() override = default;
     //
-    std::unique_ptr<Board> execute(Board &board) const override;
-    std::unique_ptr<Move> clone() const override;
+    MovePtr clone(Arena &arena) const override;
 };
 
 class QueenSideCastleMove : public CastleMove {
@@ -149,8 +168,7 @@ class QueenSideCastleMove : public CastleMove {
     using CastleMove::CastleMove;
     ~QueenSideCastleMove() override = default;
     //
-    std::unique_ptr<Board> execute(Board &board) const override;
-    std::unique_ptr<Move> clone() const override;
+    MovePtr clone(Arena &arena) const override;
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,82 @@
+#ifndef MOVE_GENERATOR_H
+#define MOVE_GENERATOR_H
+#include "compact_move.h"
+#include "position.h"
+#include <array>
+
+// Moves of one position in a fixed array, so generating them allocates
+// nothing. No position has more than 218 legal moves.
+class MoveList {
+  public:
+    static constexpr int MAX_MOVES{256};
+
+  private:
+    std::array<CompactMove, MAX_MOVES> moves;
+    int size{};
+
+  public:
+    void add(CompactMove move) {
+        moves[size++] = move;
+    }
+    int getSize() const {
+        return size;
+    }
+    CompactMove &operator[](int index) {
+        return moves[index];
+    }
+    const CompactMove &operator[](int index) const {
+        return moves[index];
+    }
+    const CompactMove *begin() const {
+        return moves.data();
+    }
+    const CompactMove *end() const {
+        return moves.data() + size;
+    }
+    bool contains(CompactMove move) const {
+        for (const CompactMove listed : *this)
+            if (listed == move)
+                return true;
+        return false;
+    }
+};
+
+// Move generation straight from the bitboards of a Position, without Board,
+// Figure or Move objects.
+class MoveGenerator {
+  private:
+    static constexpr std::array<FigureType, 4> PROMOTION_TYPES{
+        FigureType::QUEEN, FigureType::ROOK, FigureType::KNIGHT,
+        FigureType::BISHOP};
+    //
+    static void addMoves(int coordinateFrom, Bitboard targets,
+                         MoveList &moveList);
+    static void addPawnCaptures(const Position &position, MoveList &moveList);
+    // figures of the color that may only move along the line to their king
+    static Bitboard calculatePinned(const Position &position,
+                                    Color::ColorT color);
+    static void addLegalKingMoves(const Position &position,
+                                  MoveList &moveList);
+    // targets are the squares a move may end on, every square when not in
+    // check, otherwise the checker and the squares between it and the king
+    static void addLegalPawnMoves(const Position &position, Bitboard targets,
+                                  Bitboard pinned, MoveList &moveList);
+    static void addLegalFigureMoves(const Position &position, Bitboard targets,
+                                    Bitboard pinned, MoveList &moveList);
+    static void addCastlingMoves(const Position &position, MoveList &moveList);
+
+  public:
+    // Pseudo-legal captures and queen promotions of the side to move, the
+    // moves of the quiescence search. Underpromotions are left out, the
+    // caller checks that the own king is not left in check.
+    static void generateCaptures(const Position &position,
+                                 MoveList &moveList);
+    // Legal moves of the side to move, no move leaves the own king in
+    // check. Pinned figures stay on the pin line, in double check only the
+    // king moves and in single check the other figures only capture the
+    // checker or block its line.
+    static void generateLegalMoves(const Position &position,
+                                   MoveList &moveList);
+};
+
+#endif
@@ -0,0 +1,181 @@
+#ifndef NNUE_H
+#define NNUE_H
+#include "board_utils.h"
+#include "color.h"
+#include "compact_move.h"
+#include "figure_type.h"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+class Position;
+
+// An efficiently updatable neural network in the HalfKP 256x2-32-32 format
+// of Stockfish 12 (.nnue). Its inputs are the figures other than the kings,
+// each by its square and the square of the king of one side, seen from that
+// side. The first layer sums the weight rows of the inputs of each side into
+// an accumulator, a move changes only a few of them, so the search updates
+// the accumulators instead of summing all the rows again. The other layers
+// run on 8 bit integers, with AVX2 or SSE4.1 kernels when the processor has
+// them and scalar code otherwise. The file is mapped into memory, the 21 MB
+// of first layer weights are read from the mapping and only the small layers
+// are copied. Like the file, the network is little-endian only.
+class Nnue {
+  public:
+    static constexpr int HALF_DIMENSIONS{256};
+    // the first layer output of each side, by color
+    struct Accumulator {
+        alignas(32) std::array<std::array<std::int16_t, HALF_DIMENSIONS>,
+                               2> values;
+    };
+    // a figure leaving a square or entering one, -1 for neither
+    struct FigureChange {
+        FigureType figureType{};
+        Color::ColorT color{};
+        int coordinateFrom{-1};
+        int coordinateToMove{-1};
+    };
+    // the figures a move changes: the moving one, a captured one, and the
+    // castling rook or the promoted figure
+    struct MoveChanges {
+        std::array<FigureChange, 3> changes{};
+        int size{};
+    };
+    // from the slowest to the fastest
+    enum class Kernels { SCALAR, SSE41, AVX2 };
+
+  private:
+    static constexpr std::uint32_t VERSION{0x7AF32F16};
+    // the figure kinds of both sides on each square, and one unused input
+    static constexpr int KING_INPUTS{641};
+    static constexpr int NUMBER_INPUTS{KING_INPUTS *
+                                      BoardUtils::NUMBER_SQUARES};
+    static constexpr int HIDDEN_DIMENSIONS{32};
+    // the kind of each FigureType, the kings are no inputs
+    static constexpr std::array<int, 6> FIGURE_KINDS{-1, 4, 3, 1, 2, 0};
+    // the figures but the kings, even on a board set up with more than a
+    // game allows
+    static constexpr int MAX_ACTIVE_INPUTS{BoardUtils::NUMBER_SQUARES - 2};
+    // the hidden sums are shifted by it before they are clipped to 0..127
+    static constexpr int WEIGHT_SHIFT{6};
+    // the output divided by it is in the units of the network, where a pawn
+    // in the endgame is worth PAWN_VALUE
+    static constexpr int OUTPUT_SCALE{16};
+    static constexpr int PAWN_VALUE{208};
+    const unsigned char *data{};
+    std::size_t size{};
+    std::string description;
+    Kernels kernels{};
+    // the rows by input, each of HALF_DIMENSIONS values, in the mapping
+    const unsigned char *inputWeights{};
+    alignas(32) std::array<std::int16_t, HALF_DIMENSIONS> inputBiases{};
+    // by output, then by input
+    alignas(32) std::array<std::int32_t, HIDDEN_DIMENSIONS> hiddenBiases1{};
+    alignas(32) std::array<std::int8_t,
+                           HIDDEN_DIMENSIONS * 2 * HALF_DIMENSIONS>
+        hiddenWeights1{};
+    alignas(32) std::array<std::int32_t, HIDDEN_DIMENSIONS> hiddenBiases2{};
+    alignas(32) std::array<std::int8_t, HIDDEN_DIMENSIONS * HIDDEN_DIMENSIONS>
+        hiddenWeights2{};
+    std::int32_t outputBias{};
+    alignas(32) std::array<std::int8_t, HIDDEN_DIMENSIONS> outputWeights{};
+    //
+    static Kernels detectKernels();
+    // the input of a figure for the side with its king on the square
+    static int getInputIndex(Color::ColorT perspective, int kingCoordinate,
+                             FigureType figureType, Color::ColorT color,
+                             int coordinate);
+    const unsigned char *getInputRow(int index) const;
+    template <typename T, std::size_t N>
+    static void read(const unsigned char *&bytes, std::array<T, N> &values);
+    static std::uint32_t readUint32(const unsigned char *&bytes);
+    // values = source plus the added rows minus the removed ones
+    void addRows(const std::int16_t *source, std::int16_t *values,
+                 const unsigned char *const *addedRows, int numberAdded,
+                 const unsigned char *const *removedRows,
+                 int numberRemoved) const;
+    // the accumulator of the side to move, then the other one, clipped to
+    // 0..127
+    void transform(const Accumulator &accumulator, Color::ColorT sideToMove,
+                   std::uint8_t *output) const;
+    // the sums of the biases and the weighted inputs, the input size is a
+    // multiple of 32
+    void affine(const std::uint8_t *input, int inputSize,
+                const std::int8_t *weights, const std::int32_t *biases,
+                int outputSize, std::int32_t *output) const;
+    static void clip(const std::int32_t *sums, int size,
+                     std::uint8_t *output);
+    //
+    static void addRowsScalar(const std::int16_t *source,
+                              std::int16_t *values,
+                              const unsigned char *const *addedRows,
+                              int numberAdded,
+                              const unsigned char *const *removedRows,
+                              int numberRemoved);
+    static void transformScalar(const std::int16_t *values,
+                                std::uint8_t *output);
+    static void affineScalar(const std::uint8_t *input, int inputSize,
+                             const std::int8_t *weights,
+                             const std::int32_t *biases, int outputSize,
+                             std::int32_t *output);
+#if defined(__x86_64__) || defined(__i386__)
+    static void addRowsSse41(const std::int16_t *source, std::int16_t *values,
+                             const unsigned char *const *addedRows,
+                             int numberAdded,
+                             const unsigned char *const *removedRows,
+                             int numberRemoved);
+    static void transformSse41(const std::int16_t *values,
+                               std::uint8_t *output);
+    static void affineSse41(const std::uint8_t *input, int inputSize,
+                            const std::int8_t *weights,
+                            const std::int32_t *biases, int outputSize,
+                            std::int32_t *output);
+    static void addRowsAvx2(const std::int16_t *source, std::int16_t *values,
+                            const unsigned char *const *addedRows,
+                            int numberAdded,
+                            const unsigned char *const *removedRows,
+                            int numberRemoved);
+    static void transformAvx2(const std::int16_t *values,
+                              std::uint8_t *output);
+    static void affineAvx2(const std::uint8_t *input, int inputSize,
+                           const std::int8_t *weights,
+                           const std::int32_t *biases, int outputSize,
+                           std::int32_t *output);
+#endif
+
+  public:
+    // throws std::runtime_error when the file cannot be mapped or is no
+    // HalfKP network
+    explicit Nnue(const std::string &path);
+    ~Nnue();
+    Nnue(const Nnue &) = delete;
+    Nnue &operator=(const Nnue &) = delete;
+    //
+    const std::string &getDescription() const;
+    Kernels getKernels() const;
+    // slower kernels give the same results, throws std::invalid_argument
+    // for kernels the processor does not have
+    void setKernels(Kernels kernels);
+    static std::string_view getKernelsName(Kernels kernels);
+    // the accumulator of the side summed from all the figures
+    void refresh(const Position &position, Color::ColorT perspective,
+                 Accumulator &accumulator) const;
+    // the accumulator of the side after a move from the one before it, the
+    // king of the side must not have moved
+    void update(const Accumulator &previous, const MoveChanges &changes,
+                Color::ColorT perspective, int kingCoordinate,
+                Accumulator &accumulator) const;
+    // in centipawns from the side to move's point of view
+    int evaluate(const Accumulator &accumulator,
+                 Color::ColorT sideToMove) const;
+    // the same with both accumulators refreshed
+    int evaluate(const Position &position) const;
+    // the changes of a move of the side to move of the position
+    static MoveChanges getMoveChanges(const Position &position,
+                                      CompactMove move);
+    static bool movesKing(const MoveChanges &changes, Color::ColorT color);
+};
+
+#endif
@@ -0,0 +1,77 @@
+#ifndef OPENING_BOOK_H
+#define OPENING_BOOK_H
+#include "compact_move.h"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <string>
+
+class Position;
+
+// A Polyglot opening book (.bin) mapped into memory. The file is an array of
+// 16 byte big-endian entries sorted by the position key: key, move, weight
+// and learn data. The moves of a position are found by a binary search over
+// the mapping, nothing is read into the heap, so a book of any size opens at
+// once and answers in microseconds.
+class OpeningBook {
+  public:
+    enum class Selection {
+        // a random move, each with a chance in proportion to its weight
+        WEIGHTED,
+        // the move with the highest weight
+        BEST
+    };
+
+  private:
+    static constexpr std::size_t ENTRY_SIZE{16};
+    // the Polyglot key layout: 12 figure kinds on 64 squares, then the four
+    // castling rights, the eight en passant files and the side to move
+    static constexpr int NUMBER_FIGURE_KINDS{12};
+    static constexpr int CASTLING_OFFSET{NUMBER_FIGURE_KINDS *
+                                         BoardUtils::NUMBER_SQUARES};
+    static constexpr int EN_PASSANT_OFFSET{CASTLING_OFFSET + 4};
+    static constexpr int TURN_OFFSET{EN_PASSANT_OFFSET +
+                                     BoardUtils::NUMBER_SQUARE_PER_ROW};
+    static constexpr int NUMBER_RANDOM_KEYS{TURN_OFFSET + 1};
+    // Polyglot kind / 2 of each FigureType, the white kind is the black one
+    // + 1
+    static constexpr std::array<int, 6> FIGURE_KINDS{5, 4, 3, 1, 2, 0};
+    // Polyglot promotion code of each FigureType, 0 for no promotion
+    static constexpr std::array<int, 6> PROMOTION_CODES{0, 4, 3, 1, 2, 0};
+    // the published Polyglot Random64 constants, so books written by other
+    // programs are found
+    static const std::array<std::uint64_t, NUMBER_RANDOM_KEYS> RANDOM_KEYS;
+    const unsigned char *data{};
+    std::size_t size{};
+    const Selection selection{};
+    std::mt19937_64 random{std::random_device{}()};
+    //
+    static std::uint64_t readBigEndian(const unsigned char *bytes,
+                                       int length);
+    // rows count from the first rank, files from the a file
+    static int getRow(int coordinate);
+    static int getFile(int coordinate);
+    // castling is written as the king taking its own rook
+    static std::uint16_t encodeMove(CompactMove move);
+    std::size_t getNumberEntries() const;
+    const unsigned char *getEntry(std::size_t index) const;
+
+  public:
+    // throws std::runtime_error when the file cannot be opened or mapped or
+    // its size is not a whole number of entries
+    explicit OpeningBook(const std::string &path,
+                         Selection selection = Selection::WEIGHTED);
+    OpeningBook(const OpeningBook &openingBook) = delete;
+    OpeningBook &operator=(const OpeningBook &openingBook) = delete;
+    ~OpeningBook();
+    //
+    // The Polyglot key of the position. The en passant file only counts
+    // when a pawn of the side to move stands ready to capture.
+    static std::uint64_t getKey(const Position &position);
+    // a legal book move of the position, a null move if it is not in the
+    // book
+    CompactMove probe(const Position &position);
+};
+
+#endif
@@ -0,0 +1,49 @@
+#ifndef PERFT_H
+#define PERFT_H
+#include "position.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+class Board;
+
+class PerftCache {
+  private:
+    struct Entry {
+        std::uint64_t key{};
+        std::uint64_t nodes{};
+        int depth{};
+    };
+    std::vector<Entry> entries;
+
+  public:
+    explicit PerftCache(std::size_t megabytes);
+    //
+    bool probe(std::uint64_t key, int depth, std::uint64_t &nodes) const;
+    void store(std::uint64_t key, int depth, std::uint64_t nodes);
+};
+
+// Counts the leaves of the legal move tree of MoveGenerator. Known totals
+// for reference positions prove the move generator correct and its speed is
+// the move generation benchmark.
+class Perft {
+  private:
+    // prints the nodes below each root move
+    static std::uint64_t divide(const Position &position, int depth,
+                                bool bulk, PerftCache *cache);
+    static int runSuite(const std::string &path, int depth, bool bulk,
+                        PerftCache *cache);
+    // counts through the Board and Player objects the CLI plays with and
+    // throws std::runtime_error where the legal moves of the player differ
+    // from those of MoveGenerator
+    static std::uint64_t perftBoard(Board &board, int depth, bool bulk);
+
+  public:
+    static std::uint64_t perft(const Position &position, int depth,
+                               bool bulk = false, PerftCache *cache = nullptr);
+    // Chess perft <depth> [fen] [--bulk] [--hash <MB>] [--expect <nodes>]
+    //     [--epd <file>] [--board]
+    static int run(const std::vector<std::string> &arguments);
+};
+
+#endif
@@ -1,61 +1,64 @@
 #ifndef PLAYER_H
 #define PLAYER_H
+#include "arena.h"
 #include "color.h"
+#include "compact_move.h"
+#include "move.h"
 #include "move_status.h"
 #include <memory>
-#include <vector>
+#include <string>
 
-class Move;
 class Board;
 class King;
-class Table;
 
 class Player {
   private:
-    virtual std::vector<std::unique_ptr<Move>> calculateCastleMoves(
-        Board &board,
-        const std::vector<std::unique_ptr<Move>> &opponentMoves) = 0;
+    // appends the castlings, made in the arena
+    virtual void calculateCastleMoves(Board &board, MoveVector &moves) = 0;
 
   protected:
     King *playerKing{};
-    std::vector<std::unique_ptr<Move>> legalMoves;
+    // holds the legal moves of the turn, released when they are calculated
+    // again
+    Arena arena;
+    MoveVector legalMoves{&arena};
     bool inCheck{};
     //
-    // potential redundant square attack check in queen side castle move
-    std::vector<Move *>
-    calculateAttackOnSquare(int coordinate,
-                            const std::vector<std::unique_ptr<Move>> &moves);
-    bool
-    hasAttackOnKing(const std::vector<std::unique_ptr<Move>> &opponentMoves);
-    bool
-    hasAttackOnKing(const King *king,
-                    const std::vector<std::unique_ptr<Move>> &opponentMoves);
-    bool hasEscapeMoves(Board &board, Player *opponent);
+    bool isKingAttacked(const Board &board) const;
+    // whether the king would be attacked on the square it passes while
+    // castling
+    bool isCastlePassAttacked(const Board &board, int coordinate) const;
 
   public:
-    explicit Player(King *king, std::vector<std::unique_ptr<Move>> &&legalMoves,
-                    bool inCheck = false);
+    // the legal moves are calculated by updateLegalMoves
+    explicit Player(King *king, bool inCheck = false);
     Player(const Player &player);
     virtual ~Player() = default;
     //
-    std::vector<std::unique_ptr<Move>> &getLegalMoves();
+    MoveVector &getLegalMoves();
+    // the arena of the legal moves, its counters cover their last
+    // calculation
+    const Arena &getArena() const;
+    // the legal move with the same encoding, nullptr if there is none
+    Move *getLegalMove(CompactMove compactMove) const;
     virtual Color::ColorT getColor() const = 0;
     //
     MoveStatus makeMove(Move *move, Board &board, Player *opponent);
-    std::vector<std::unique_ptr<Move>> calculateAllLegalMoves(
-        Board &board, const std::vector<std::unique_ptr<Move>> &opponentMoves);
+    // the figure moves and castlings that MoveGenerator finds legal for the
+    // player's color, whoever is to move
+    MoveVector calculateAllLegalMoves(Board &board);
+    // releases the legal moves with their arena and calculates them again,
+    // every move of the old list is invalid afterwards
+    void updateLegalMoves(Board &board);
     bool isInCheck() const;
-    bool isInCheckMate(Board &board, Player *opponent);
+    bool isInCheckMate() const;
     virtual std::string getPlayerName() const = 0;
     //
-    friend Table;
 };
 
 class WhitePlayer : public Player {
   private:
-    std::vector<std::unique_ptr<Move>> calculateCastleMoves(
-        Board &board,
-        const std::vector<std::unique_ptr<Move>> &opponentMoves) override;
+    void calculateCastleMoves(Board &board, MoveVector &moves) override;
 
   public:
     using Player::Player;
@@ -66,9 +69,7 @@ class WhitePlayer : public Player {
 
 class BlackPlayer : public Player {
   private:
-    std::vector<std::unique_ptr<Move>> calculateCastleMoves(
-        Board &board,
-        const std::vector<std::unique_ptr<Move>> &opponentMoves) override;
+    void calculateCastleMoves(Board &board, MoveVector &moves) override;
 
   public:
     using Player::Player;
@@ -0,0 +1,116 @@
+#ifndef POSITION_H
+#define POSITION_H
+#include "bitboard.h"
+#include "board_utils.h"
+#include "color.h"
+#include "compact_move.h"
+#include "evaluation.h"
+#include "figure_type.h"
+#include "zobrist.h"
+#include <array>
+#include <cstdint>
+
+// Value-type piece placement: one bitboard per figure type and per color plus
+// the occupancy, and a mailbox for constant time lookups by square. It holds
+// no pointers, so copying a position is a plain memcpy. Every mutator keeps
+// the Zobrist keys and the sums of the evaluation up to date.
+class Position {
+  public:
+    static constexpr int NUMBER_FIGURE_TYPES{6};
+    static constexpr int NUMBER_COLORS{2};
+    // castling rights bits
+    static constexpr int WHITE_KING_SIDE{1};
+    static constexpr int WHITE_QUEEN_SIDE{2};
+    static constexpr int BLACK_KING_SIDE{4};
+    static constexpr int BLACK_QUEEN_SIDE{8};
+
+  private:
+    static constexpr std::array<int, NUMBER_FIGURE_TYPES> FIGURE_VALUES{
+        90, 9, 5, 3, 3, 1};
+    // the castling rights lost when a figure moves from or to the square
+    static constexpr std::array<int, BoardUtils::NUMBER_SQUARES>
+        CASTLING_MASKS{[] {
+            std::array<int, BoardUtils::NUMBER_SQUARES> masks{};
+            masks[0] = BLACK_QUEEN_SIDE;
+            masks[4] = BLACK_KING_SIDE | BLACK_QUEEN_SIDE;
+            masks[7] = BLACK_KING_SIDE;
+            masks[56] = WHITE_QUEEN_SIDE;
+            masks[60] = WHITE_KING_SIDE | WHITE_QUEEN_SIDE;
+            masks[63] = WHITE_KING_SIDE;
+            return masks;
+        }()};
+    std::array<Bitboard, NUMBER_FIGURE_TYPES> figureBoards{};
+    std::array<Bitboard, NUMBER_COLORS> colorBoards{};
+    Bitboard occupancy{};
+    // figure type + 1 of the figure on each square, 0 for an empty square
+    std::array<std::uint8_t, BoardUtils::NUMBER_SQUARES> mailbox{};
+    Color::ColorT sideToMove{Color::ColorT::WHITE};
+    int castlingRights{};
+    // the square passed by a pawn jump, -1 if there is none
+    int enPassantCoordinate{-1};
+    // plies since the last capture or pawn move, not part of the key
+    int halfmoveClock{};
+    // starts at 1 and grows after each move of black, not part of the key
+    int fullmoveNumber{1};
+    std::uint64_t key{};
+    // the key of the pawns alone, for the pawn table of the evaluation
+    std::uint64_t pawnKey{};
+    // the key of the figure counts, for the material table
+    std::uint64_t materialKey{};
+    // white's piece-square values minus black's
+    int middlegameScore{};
+    int endgameScore{};
+    // the phase weights of the figures on the board
+    int phase{};
+
+  public:
+    static constexpr int getFigureValue(FigureType figureType) {
+        return FIGURE_VALUES[static_cast<int>(figureType)];
+    }
+    //
+    void addFigure(FigureType figureType, Color::ColorT color, int coordinate);
+    void removeFigure(int coordinate);
+    void moveFigure(int coordinate, int coordinateToMove);
+    Color::ColorT getSideToMove() const;
+    void setSideToMove(Color::ColorT color);
+    int getCastlingRights() const;
+    void setCastlingRights(int castlingRights);
+    int getEnPassantCoordinate() const;
+    void setEnPassantCoordinate(int coordinate);
+    int getHalfmoveClock() const;
+    void setHalfmoveClock(int halfmoveClock);
+    int getFullmoveNumber() const;
+    void setFullmoveNumber(int fullmoveNumber);
+    std::uint64_t getKey() const;
+    // the key computed from scratch, it equals getKey() unless the
+    // incremental updates are broken
+    std::uint64_t calculateKey() const;
+    std::uint64_t getPawnKey() const;
+    std::uint64_t getMaterialKey() const;
+    int getMiddlegameScore() const;
+    int getEndgameScore() const;
+    int getPhase() const;
+    // plays a pseudo-legal move of the side to move, the position is copied
+    // to take the move back
+    void makeMove(CompactMove move);
+    //
+    Bitboard getOccupancy() const;
+    Bitboard getFigures(FigureType figureType) const;
+    Bitboard getFigures(Color::ColorT color) const;
+    Bitboard getFigures(FigureType figureType, Color::ColorT color) const;
+    bool isOccupied(int coordinate) const;
+    FigureType getFigureType(int coordinate) const;
+    Color::ColorT getColor(int coordinate) const;
+    int getKingCoordinate(Color::ColorT color) const;
+    int getMaterial(Color::ColorT color) const;
+    bool isSquareAttacked(int coordinate, Color::ColorT byColor) const;
+    // the figures of both colors attacking the square, sliders seen through
+    // the given occupancy
+    Bitboard attackersTo(int coordinate, Bitboard occupancy) const;
+    bool isInCheck(Color::ColorT color) const;
+    // the move resets the halfmove clock
+    bool isIrreversible(CompactMove move) const;
+    bool operator==(const Position &other) const = default;
+};
+
+#endif
@@ -0,0 +1,30 @@
+#ifndef SEARCH_CONTROL_H
+#define SEARCH_CONTROL_H
+#include <atomic>
+#include <chrono>
+
+// The state of one search shared by its threads and by the front end that
+// started it, which may stop it from another thread. While the search is
+// pondering no limit applies, the ponder hit restarts the clock unless the
+// time already searched counts.
+class SearchControl {
+  private:
+    std::atomic<bool> stop{};
+    std::atomic<bool> pondering{};
+    // steady clock ticks of the start, moved to the ponder hit
+    std::atomic<std::chrono::steady_clock::rep> startTicks{};
+
+  public:
+    // clears the stop flag and starts the clock, called before the search
+    // threads run
+    void start(bool ponder = false);
+    void requestStop();
+    bool isStopped() const;
+    bool isPondering() const;
+    // the opponent played the expected move, the limits apply from now on,
+    // from the start of the search if the clock is not restarted
+    void ponderHit(bool restartClock = true);
+    std::chrono::milliseconds getElapsedTime() const;
+};
+
+#endif
@@ -0,0 +1,23 @@
+#ifndef SEARCH_INFO_H
+#define SEARCH_INFO_H
+#include "compact_move.h"
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+// Progress of a search after an iteration of the main thread, what a UCI
+// info line reports.
+struct SearchInfo {
+    int depth{};
+    // from the side to move's point of view, in centipawns
+    int score{};
+    // of all threads
+    std::uint64_t nodes{};
+    std::chrono::milliseconds time{};
+    // used transposition table entries per mille
+    int hashfull{};
+    // the best move and the expected replies
+    std::vector<CompactMove> principalVariation;
+};
+
+#endif
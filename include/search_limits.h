@@ -0,0 +1,18 @@
+#ifndef SEARCH_LIMITS_H
+#define SEARCH_LIMITS_H
+#include <chrono>
+#include <cstdint>
+
+// Budget of one search, a zero value leaves that limit out. The search
+// deepens until the first limit is reached.
+struct SearchLimits {
+    // no new iteration is started after half of it, the running one is
+    // stopped when it is used up
+    std::chrono::milliseconds maxTime{};
+    // the search uses all of it
+    std::chrono::milliseconds moveTime{};
+    std::uint64_t maxNodes{};
+    int maxDepth{};
+};
+
+#endif
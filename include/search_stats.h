@@ -0,0 +1,52 @@
+#ifndef SEARCH_STATS_H
+#define SEARCH_STATS_H
+#include <cstdint>
+
+// Counters of one search. A perfectly ordered alpha-beta tree cuts off on
+// the first move at every cut node, so the first move cutoff rate tells how
+// close the move ordering is to the minimal tree.
+struct SearchStats {
+    std::uint64_t nodes{};
+    // counted apart from the nodes, to see how much of the tree is spent
+    // on quiescence search
+    std::uint64_t quiescenceNodes{};
+    std::uint64_t cutoffs{};
+    std::uint64_t firstMoveCutoffs{};
+    // probes and hits of the pawn and material tables of the evaluation
+    std::uint64_t pawnProbes{};
+    std::uint64_t pawnHits{};
+    std::uint64_t materialProbes{};
+    std::uint64_t materialHits{};
+    //
+    SearchStats &operator+=(const SearchStats &other) {
+        nodes += other.nodes;
+        quiescenceNodes += other.quiescenceNodes;
+        cutoffs += other.cutoffs;
+        firstMoveCutoffs += other.firstMoveCutoffs;
+        pawnProbes += other.pawnProbes;
+        pawnHits += other.pawnHits;
+        materialProbes += other.materialProbes;
+        materialHits += other.materialHits;
+        return *this;
+    }
+    // share of the beta cutoffs caused by the first searched move, in
+    // percent
+    double getFirstMoveCutoffRate() const {
+        if (!cutoffs)
+            return 0;
+        return 100.0 * firstMoveCutoffs / cutoffs;
+    }
+    // in percent
+    double getPawnHitRate() const {
+        if (!pawnProbes)
+            return 0;
+        return 100.0 * pawnHits / pawnProbes;
+    }
+    double getMaterialHitRate() const {
+        if (!materialProbes)
+            return 0;
+        return 100.0 * materialHits / materialProbes;
+    }
+};
+
+#endif
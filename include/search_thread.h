@@ -0,0 +1,163 @@
+#ifndef SEARCH_THREAD_H
+#define SEARCH_THREAD_H
+#include "board_utils.h"
+#include "color.h"
+#include "compact_move.h"
+#include "evaluation.h"
+#include "nnue.h"
+#include "search_control.h"
+#include "search_limits.h"
+#include "search_stats.h"
+#include "tablebase.h"
+#include "transposition_table.h"
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+class MoveList;
+class Position;
+
+// One thread of the bot search: negamax alpha-beta with iterative deepening
+// on value copies of the root position. Scores are in centipawns from the
+// side to move's point of view. All threads share the transposition table
+// and the search control, the main thread (id 0) checks the limits and
+// stops the search.
+class SearchThread {
+  public:
+    // called by the main thread after each completed iteration with its
+    // depth, score and best move
+    using IterationCallback =
+        std::function<void(int depth, int score, CompactMove bestMove)>;
+    // fits the score of a transposition table entry
+    static constexpr int INFINITE_SCORE{32000};
+    static constexpr int MAX_DEPTH{64};
+    // the score of being mated at the root, a mate in more plies scores
+    // closer to zero
+    static constexpr int MATE_SCORE{INFINITE_SCORE - 1};
+
+  private:
+    // scores beyond it are mates, they are stored in the transposition
+    // table relative to the node instead of the root; the mates of the
+    // tablebase lie beyond the search horizon
+    static constexpr int MATE_BOUND{MATE_SCORE - MAX_DEPTH -
+                                    Tablebase::MAX_PLIES};
+    // the clock is read once per this many nodes
+    static constexpr std::uint64_t TIME_CHECK_INTERVAL{1024};
+    // move ordering scores, from the first tried to the last
+    static constexpr int HASH_MOVE_SCORE{1'000'000};
+    static constexpr int CAPTURE_SCORE{500'000};
+    static constexpr std::array<int, 2> KILLER_SCORES{400'000, 300'000};
+    // history scores are halved once one of them reaches it, so quiet moves
+    // always sort below the killers
+    static constexpr int MAX_HISTORY_SCORE{200'000};
+    // quiescence search skips captures that leave the score this far below
+    // alpha even when the victim is won for free
+    static constexpr int DELTA_MARGIN{200};
+    // a draw is claimed after this many plies without capture or pawn move
+    static constexpr int FIFTY_MOVE_PLIES{100};
+    // the plies of the deepest search and of its quiescence search, which
+    // plays at most the captures of all the figures and the promotions of
+    // all the pawns
+    static constexpr int MAX_NETWORK_PLIES{2 * MAX_DEPTH + 1};
+    // the accumulators of a ply are computed when its node is evaluated,
+    // from the changes of the move that led to it
+    struct NetworkPly {
+        Nnue::Accumulator accumulator;
+        Nnue::MoveChanges changes;
+        std::array<bool, 2> isComputed{};
+    };
+    const int id{};
+    TranspositionTable &transpositionTable;
+    const SearchLimits &limits;
+    SearchControl &control;
+    const IterationCallback onIteration;
+    // the endings it holds are scored without a search, may be null
+    const Tablebase *tablebase{};
+    // evaluates instead of the tapered evaluation, may be null
+    const Nnue *nnue{};
+    SearchStats stats;
+    // the caches of the evaluation, their counters go to the stats at the
+    // end of the search
+    PawnTable pawnTable{PawnEntry::DEFAULT_ENTRIES};
+    MaterialTable materialTable{MaterialEntry::DEFAULT_ENTRIES};
+    // the nodes of the stats, readable by other threads during the search
+    std::atomic<std::uint64_t> searchedNodes{};
+    int completedDepth{};
+    // root score of the best move returned by the last iteration
+    int score{};
+    // quiet moves that caused a cutoff, two per ply
+    std::array<std::array<CompactMove, 2>, MAX_DEPTH> killers{};
+    // butterfly table: cutoffs of quiet moves by side, from and to square,
+    // weighted by the squared remaining depth
+    std::array<std::array<std::array<int, BoardUtils::NUMBER_SQUARES>,
+                          BoardUtils::NUMBER_SQUARES>,
+               2>
+        history{};
+    // keys of the positions from the root to the current node, by ply
+    std::array<std::uint64_t, MAX_DEPTH + 1> pathKeys{};
+    // by ply, only allocated with a network
+    std::vector<NetworkPly> networkPlies;
+    //
+    // stops the search once a limit is reached, never before the first
+    // iteration of the main thread is complete nor while pondering
+    bool isTimeToStop();
+    // a repetition since the root or the fifty move rule
+    bool isDraw(const Position &position, int ply) const;
+    // the hash move, captures by most valuable victim and least valuable
+    // attacker, the killers of the ply, then quiet moves by history
+    void orderMoves(MoveList &moveList, const Position &position,
+                    CompactMove hashMove, int ply) const;
+    int scoreMove(CompactMove move, const Position &position,
+                  CompactMove hashMove, int ply) const;
+    static bool isCapture(CompactMove move, const Position &position);
+    // most valuable victim, then least valuable attacker
+    static int getCaptureScore(CompactMove move, const Position &position);
+    // in pawns
+    static int getVictimValue(CompactMove move, const Position &position);
+    void updateQuietCutoff(CompactMove move, Color::ColorT color, int depth,
+                           int ply);
+    static TranspositionTable::Bound getBound(int score, int alpha, int beta);
+    static int scoreToTable(int score, int ply);
+    static int scoreFromTable(int score, int ply);
+    // the mate distances of the tablebase count from the node
+    static int scoreFromTablebase(const Tablebase::Result &result, int ply);
+    // records the move of the position that leads to the ply
+    void pushNetworkMove(int ply, const Position &position, CompactMove move);
+    // Each accumulator is updated ply by ply from the last one computed on
+    // the path, or refreshed when the king of its side moved since.
+    int evaluateNetwork(int ply, const Position &position);
+    // from the side to move's point of view
+    int evaluate(int ply, const Position &position);
+
+  public:
+    SearchThread(int id, TranspositionTable &transpositionTable,
+                 const SearchLimits &limits, SearchControl &control,
+                 IterationCallback onIteration = {},
+                 const Tablebase *tablebase = nullptr,
+                 const Nnue *nnue = nullptr);
+    //
+    // Iterative deepening until the search is stopped or the depth limit,
+    // returns the best move of the deepest iteration, or of the stopped one
+    // if it found a better move. Helper threads with an odd id skip the
+    // first ply, so the threads do not all work on the same depth.
+    CompactMove search(const Position &position);
+    CompactMove searchRoot(int depth, const Position &position);
+    int negamax(int depth, int ply, const Position &position, int alpha,
+                int beta);
+    // Captures only. The side to move may stand pat on the static
+    // evaluation instead of capturing.
+    int quiescence(int ply, const Position &position, int alpha, int beta);
+    const SearchStats &getStats() const;
+    int getCompletedDepth() const;
+    int getScore() const;
+    std::uint64_t getSearchedNodes() const;
+    static bool isMateScore(int score);
+    // moves to the mate of a mate score, negative or 0 when the side to move
+    // is mated
+    static int getMateMoves(int score);
+};
+
+#endif
@@ -0,0 +1,135 @@
+#ifndef TABLEBASE_H
+#define TABLEBASE_H
+#include "board_utils.h"
+#include "color.h"
+#include "figure_type.h"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <string_view>
+
+class Position;
+
+// The figures of an ending, kings included, and the index of its positions.
+// The figures are ordered as the white king, the black king, the other white
+// figures and the other black ones, each by figure type. The stronger side
+// is white: more figures, or the stronger first different figure. The index
+// is the same for every position a symmetry of the board maps onto another:
+// the white king is brought to the a1-d1-d4 triangle, or to the files a to d
+// when pawns fix the direction of the board.
+class Ending {
+  public:
+    static constexpr int MAX_FIGURES{4};
+    using Squares = std::array<int, MAX_FIGURES>;
+
+  private:
+    // by figure type
+    static constexpr std::string_view FIGURE_SYMBOLS{"KQRNBP"};
+    static constexpr int NUMBER_SYMMETRIES{8};
+    static constexpr int FILE_MIRROR{1};
+    static constexpr int ROW_MIRROR{2};
+    static constexpr int TRANSPOSITION{4};
+    // kings squares of the index without and with pawns
+    static constexpr int NUMBER_TRIANGLE_SQUARES{10};
+    static constexpr int NUMBER_HALF_SQUARES{32};
+    using SymmetryTable =
+        std::array<std::array<int, BoardUtils::NUMBER_SQUARES>,
+                   NUMBER_SYMMETRIES>;
+    // the square of a coordinate under each symmetry
+    static const SymmetryTable SYMMETRIES;
+    // the index of a square in the triangle, -1 outside of it
+    static const std::array<int, BoardUtils::NUMBER_SQUARES> TRIANGLE_INDICES;
+    static const std::array<int, NUMBER_TRIANGLE_SQUARES> TRIANGLE_SQUARES;
+    int numberFigures{};
+    std::array<FigureType, MAX_FIGURES> figureTypes{};
+    std::array<Color::ColorT, MAX_FIGURES> colors{};
+    bool hasPawns{};
+    // the last two figures are the same, so they are sorted in the index
+    bool hasTwins{};
+    //
+    static SymmetryTable initSymmetries();
+    static std::array<int, BoardUtils::NUMBER_SQUARES> initTriangleIndices();
+    static std::array<int, NUMBER_TRIANGLE_SQUARES> initTriangleSquares();
+    // -1 when the symmetry does not bring the king to its squares
+    int getKingIndex(int coordinate) const;
+    int getKingCoordinate(int kingIndex) const;
+
+  public:
+    // the other figures of each side, stronger first, are sorted
+    Ending(std::string_view whiteFigures, std::string_view blackFigures);
+    //
+    // "KQvKR" for example, throws std::invalid_argument for a name of no
+    // ending or of more than MAX_FIGURES figures
+    static Ending fromName(std::string_view name);
+    // the ending of a position of at most MAX_FIGURES figures, mirrored
+    // when black is the stronger side
+    static Ending fromPosition(const Position &position, bool &isMirrored);
+    std::string getName() const;
+    int getNumberFigures() const;
+    FigureType getFigureType(int figure) const;
+    Color::ColorT getColor(int figure) const;
+    bool getHasPawns() const;
+    int getNumberPawns() const;
+    // positions of one side to move, including the illegal ones
+    std::size_t getNumberPositions() const;
+    std::size_t getIndex(Squares squares) const;
+    // the inverse of getIndex, for the index of the figures as they are
+    Squares getSquares(std::size_t index) const;
+    // the squares of the figures of a position of the ending, with the
+    // colors swapped and the rows mirrored if it is mirrored
+    Squares getSquares(const Position &position, bool isMirrored) const;
+    Position getPosition(const Squares &squares,
+                         Color::ColorT sideToMove) const;
+};
+
+// Distance to mate tables of the endings of up to Ending::MAX_FIGURES
+// figures, written by TablebaseGenerator and mapped into memory. A table
+// holds one byte per position and side to move: 0 for a draw, or the plies
+// to the mate + 1. The side to move wins when they are odd. Positions with
+// castling rights or an en passant capture are not in the tables.
+class Tablebase {
+  public:
+    static constexpr std::string_view FILE_EXTENSION{".tb"};
+    // the longest mate a table can hold
+    static constexpr int MAX_PLIES{UINT8_MAX - 1};
+    enum class Outcome {
+        LOSS,
+        DRAW,
+        WIN
+    };
+    // for the side to move
+    struct Result {
+        Outcome outcome{Outcome::DRAW};
+        // plies to the mate, 0 for a draw
+        int plies{};
+    };
+
+  private:
+    struct Table {
+        const std::uint8_t *data{};
+        std::size_t size{};
+        Ending ending;
+    };
+    // by the name of the ending
+    std::map<std::string, Table> tables;
+
+  public:
+    Tablebase() = default;
+    // maps every table of the directory, throws std::runtime_error when one
+    // cannot be mapped or does not fit its ending
+    explicit Tablebase(const std::string &directory);
+    Tablebase(const Tablebase &tablebase) = delete;
+    Tablebase &operator=(const Tablebase &tablebase) = delete;
+    ~Tablebase();
+    //
+    void addTable(const std::string &path);
+    std::size_t getNumberTables() const;
+    // false when the ending of the position has no table
+    bool probe(const Position &position, Result &result) const;
+    // the result of a table entry
+    static Result getResult(std::uint8_t value);
+};
+
+#endif
@@ -0,0 +1,87 @@
+#ifndef TABLEBASE_GENERATOR_H
+#define TABLEBASE_GENERATOR_H
+#include "color.h"
+#include "tablebase.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Retrograde generation of the distance to mate tables. Every legal
+// position of an ending is first scored by its moves out of the ending,
+// captures and promotions, from the tables generated before, and its moves
+// within the ending are counted. Then the positions are resolved level by
+// level of plies to the mate: every move back from a position lost in n
+// plies comes from a position won in n + 1, and a position is lost once all
+// its moves within the ending lead to won positions of the opponent. Each
+// level is shared out among the threads. When both sides have pawns, a pawn
+// jump the opponent can take en passant leads to a position of its own,
+// resolved like the others but not written: the tables leave out en passant
+// captures, not the positions before them.
+class TablebaseGenerator {
+  private:
+    // positions per task of a thread
+    static constexpr std::size_t BLOCK_SIZE{1 << 14};
+    // the most moves back of one side: a king and two queens
+    static constexpr int MAX_PREDECESSORS{64};
+    // counter of the positions that are illegal or have another index
+    static constexpr std::uint8_t ILLEGAL{UINT8_MAX};
+    // exit loss of the positions a move out of the ending saves from a loss
+    static constexpr std::uint8_t NO_LOSS{UINT8_MAX};
+    const std::string directory;
+    const int threads{};
+    // the tables generated so far, for the moves out of the ending
+    Tablebase tablebase;
+    // The state of the ending being generated, by side to move * number of
+    // positions + index, then the same for the positions right after a pawn
+    // jump that can be taken en passant. The values are the entries of the
+    // table, the counters the moves within the ending not yet known to lose.
+    std::vector<std::uint8_t> values;
+    std::vector<std::uint8_t> counters;
+    // the level a move out of the ending resolves the position at, 0 for
+    // none
+    std::vector<std::uint8_t> pendingLevels;
+    // the plies of the longest loss by a move out of the ending
+    std::vector<std::uint8_t> exitLosses;
+    //
+    // whether a pawn of the side to move can take the pawn on the square en
+    // passant, had it just jumped there
+    static bool canCaptureEnPassant(const Ending &ending,
+                                    const Ending::Squares &squares,
+                                    Color::ColorT sideToMove,
+                                    int pawnCoordinate);
+    // the state index of a position, the en passant one if the last move was
+    // a pawn jump that can be taken
+    static std::size_t getStateIndex(const Ending &ending,
+                                     const Position &position);
+    // runs the function on blocks of positions on every thread, returns the
+    // sum of its results and throws the first exception of a thread
+    template <typename Function>
+    std::size_t runParallel(std::size_t size, Function function);
+    // scores the moves out of the ending and counts the others, returns the
+    // level of the pending result
+    int initPosition(const Ending &ending, std::size_t position);
+    // propagates the result of a position resolved at the level to the
+    // positions before it, returns the highest pending level it set
+    int propagate(const Ending &ending, std::size_t position, int level);
+    // the distinct legal positions before the position, by the other side
+    int getPredecessors(const Ending &ending, const Ending::Squares &squares,
+                        Color::ColorT sideToMove, bool isEnPassant,
+                        std::array<std::size_t, MAX_PREDECESSORS>
+                            &predecessors);
+
+  public:
+    // zero threads runs one thread per hardware thread
+    TablebaseGenerator(const std::string &directory, int threads);
+    //
+    // generates the table of the ending and writes it to the directory, the
+    // tables its moves out of it lead to must be there
+    void generate(const Ending &ending);
+    // every ending of up to the number of figures, each after the endings
+    // its captures and promotions lead to
+    static std::vector<Ending> getEndings(int maxFigures);
+    // Chess tablebase --output <dir> [--figures <3 or 4>] [--threads <N>]
+    static int run(const std::vector<std::string> &arguments);
+};
+
+#endif
@@ -0,0 +1,70 @@
+#ifndef TRANSPOSITION_TABLE_H
+#define TRANSPOSITION_TABLE_H
+#include "compact_move.h"
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+// Search results by Zobrist key, shared by all search threads without locks.
+// Entries are grouped in buckets of one cache line, a probe reads a single
+// line and a store replaces the entry of the bucket that is the shallowest
+// and the oldest.
+class TranspositionTable {
+  public:
+    enum class Bound : std::uint8_t {
+        NONE,
+        EXACT,
+        // the score is at least the stored one (fail high)
+        LOWER,
+        // the score is at most the stored one (fail low)
+        UPPER
+    };
+    struct Entry {
+        std::uint64_t key{};
+        CompactMove bestMove;
+        std::int16_t score{};
+        std::int8_t depth{};
+        Bound bound{Bound::NONE};
+        std::uint8_t generation{};
+    };
+    static constexpr std::size_t DEFAULT_MEGABYTES{16};
+
+  private:
+    // An entry packed into one word, stored next to the key XOR that word.
+    // A slot torn by two threads writing at once fails the key check on
+    // probe and reads as empty.
+    struct Slot {
+        std::atomic<std::uint64_t> keyXorData;
+        std::atomic<std::uint64_t> data;
+    };
+    static constexpr int BUCKET_SIZE{4};
+    struct alignas(64) Bucket {
+        std::array<Slot, BUCKET_SIZE> slots{};
+    };
+    std::unique_ptr<Bucket[]> buckets;
+    std::size_t bucketCount{};
+    std::uint8_t generation{};
+    //
+    Bucket &getBucket(std::uint64_t key) const;
+    static std::uint64_t pack(const Entry &entry);
+    static Entry unpack(std::uint64_t key, std::uint64_t data);
+
+  public:
+    explicit TranspositionTable(std::size_t megabytes = DEFAULT_MEGABYTES);
+    //
+    // the number of buckets is rounded down to a power of two
+    void resize(std::size_t megabytes);
+    // not thread safe, like resize and newSearch
+    void clear();
+    // ages the entries of the previous searches, called once per search
+    void newSearch();
+    bool probe(std::uint64_t key, Entry &entry) const;
+    void store(std::uint64_t key, int depth, int score, Bound bound,
+               CompactMove bestMove);
+    // entries of the current search per mille, sampled from the first
+    // thousand buckets
+    int getHashfull() const;
+};
+
+#endif
@@ -0,0 +1,71 @@
+#ifndef UCI_H
+#define UCI_H
+#include "ai.h"
+#include "position.h"
+#include "search_control.h"
+#include "search_info.h"
+#include "search_limits.h"
+#include "transposition_table.h"
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+
+// The Universal Chess Interface front end: commands are read from stdin and
+// answered on stdout. The search runs on a thread of its own, so stop,
+// ponderhit and isready are answered while it runs.
+class Uci {
+  private:
+    static constexpr char ENGINE_NAME[]{"Chess"};
+    static constexpr int MAX_HASH_MEGABYTES{4096};
+    static constexpr int MAX_THREADS{256};
+    // the value of a string option that is not set
+    static constexpr char EMPTY_VALUE[]{"<empty>"};
+    // moves left assumed when the time control does not give them
+    static constexpr int DEFAULT_MOVES_TO_GO{30};
+    // kept back from the clock for the communication with the GUI
+    static constexpr std::chrono::milliseconds MOVE_OVERHEAD{50};
+    std::size_t hashMegabytes{TranspositionTable::DEFAULT_MEGABYTES};
+    int threads{1};
+    // the directory of the distance to mate tables, empty for none
+    std::string tablebasePath;
+    std::unique_ptr<AI> ai;
+    Position position;
+    SearchControl control;
+    // guards the output and the release of the best move
+    std::mutex mutex;
+    std::condition_variable bestMoveReleased;
+    // the best move of an infinite or pondering search waits for stop or
+    // ponderhit
+    bool isInfinite{};
+    bool isStopRequested{};
+    std::jthread searcher;
+    //
+    void setPosition(std::istringstream &tokens);
+    void go(std::istringstream &tokens);
+    void setOption(std::istringstream &tokens);
+    // a bot of the hash size and threads, with the tables of the path
+    void createAi();
+    // runs on the searcher thread
+    void search(const Position &rootPosition, const SearchLimits &limits);
+    // stops a running search and waits for its best move
+    void stop();
+    void ponderHit();
+    void sendInfo(const SearchInfo &info);
+    void send(const std::string &line);
+    // the legal move in coordinate notation, a null move if there is none
+    static CompactMove parseMove(const Position &position,
+                                 const std::string &name);
+    static std::string formatScore(int score);
+
+  public:
+    Uci();
+    //
+    // reads commands until quit or the end of the input
+    void run();
+};
+
+#endif
@@ -0,0 +1,64 @@
+#ifndef ZOBRIST_H
+#define ZOBRIST_H
+#include "board_utils.h"
+#include "color.h"
+#include "figure_type.h"
+#include <array>
+#include <cstdint>
+
+// Random keys of the Zobrist hash. A position key is the XOR of the keys of
+// its figures, of the side key when black is to move, of its castling rights
+// and of its en passant file, so a move updates it with a few XORs.
+class Zobrist {
+  public:
+    static constexpr int NUMBER_CASTLING_RIGHTS{16};
+
+  private:
+    static constexpr int NUMBER_FIGURE_TYPES{6};
+    static constexpr int NUMBER_FIGURE_KEYS{2 * NUMBER_FIGURE_TYPES *
+                                            BoardUtils::NUMBER_SQUARES};
+    static const std::array<std::uint64_t, NUMBER_FIGURE_KEYS> FIGURE_KEYS;
+    static const std::array<std::uint64_t, NUMBER_CASTLING_RIGHTS>
+        CASTLING_KEYS;
+    static const std::array<std::uint64_t, BoardUtils::NUMBER_SQUARE_PER_ROW>
+        EN_PASSANT_KEYS;
+    static const std::uint64_t SIDE_KEY;
+    //
+    static std::uint64_t nextRandom(std::uint64_t &seed);
+    template <std::size_t N>
+    static std::array<std::uint64_t, N> initKeys(std::uint64_t seed);
+    // each of the four rights has a key, a set of rights XORs them together
+    static std::array<std::uint64_t, NUMBER_CASTLING_RIGHTS>
+    initCastlingKeys(std::uint64_t seed);
+
+  public:
+    static std::uint64_t getFigureKey(FigureType figureType,
+                                      Color::ColorT color, int coordinate) {
+        return FIGURE_KEYS[(static_cast<int>(color) * NUMBER_FIGURE_TYPES +
+                            static_cast<int>(figureType)) *
+                               BoardUtils::NUMBER_SQUARES +
+                           coordinate];
+    }
+    // the key of the count-th figure of a type and color, counting from 0,
+    // the material key XORs one per figure on the board; the count takes
+    // the place of the square of the figure keys
+    static std::uint64_t getMaterialKey(FigureType figureType,
+                                        Color::ColorT color, int count) {
+        return getFigureKey(figureType, color, count);
+    }
+    static std::uint64_t getSideKey() {
+        return SIDE_KEY;
+    }
+    static std::uint64_t getCastlingKey(int castlingRights) {
+        return CASTLING_KEYS[castlingRights];
+    }
+    // the key of the file of the en passant square, 0 for no square (-1)
+    static std::uint64_t getEnPassantKey(int coordinate) {
+        return coordinate < 0
+                   ? 0
+                   : EN_PASSANT_KEYS[coordinate %
+                                     BoardUtils::NUMBER_SQUARE_PER_ROW];
+    }
+};
+
+#endif
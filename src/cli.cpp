@@ -3,32 +3,30 @@
 #include "board.h"
 #include "figure.h"
 #include "move.h"
+#include "nnue.h"
+#include "opening_book.h"
 #include "player.h"
+#include "tablebase.h"
 #include <format>
 #include <iostream>
 #include <limits>
+#include <vector>
 
-Table::Table() {
+Table::Table(std::size_t hashMegabytes, int threads,
+             std::unique_ptr<OpeningBook> openingBook,
+             std::unique_ptr<Tablebase> tablebase,
+             std::unique_ptr<Nnue> network)
+    : ai(std::make_unique<AI>(hashMegabytes, threads)) {
+    ai->setOpeningBook(std::move(openingBook));
+    ai->setTablebase(std::move(tablebase));
+    ai->setNetwork(std::move(network));
     setGameMode();
     setDifficulty();
     setPlayers();
 }
 
-Table::Table(const Table &table)
-    : board(std::make_unique<Board>(*table.board)),
-      whitePlayer(std::make_unique<WhitePlayer>(
-          table.board->getKing(Color::ColorT::WHITE),
-          table.board->calculateLegalMoves(Color::ColorT::WHITE),
-          table.whitePlayer->inCheck)),
-      blackPlayer(std::make_unique<BlackPlayer>(
-          table.board->getKing(Color::ColorT::BLACK),
-          table.board->calculateLegalMoves(Color::ColorT::BLACK),
-          table.blackPlayer->inCheck)),
-      gameMode(table.gameMode), difficulty(table.difficulty) {
-    whitePlayer->legalMoves = whitePlayer->calculateAllLegalMoves(
-        *board, blackPlayer->getLegalMoves());
-    blackPlayer->legalMoves = blackPlayer->calculateAllLegalMoves(
-        *board, whitePlayer->getLegalMoves());
+Table::~Table() {
+    stopPondering();
 }
 
 Board *Table::getBoard() {
@@ -73,7 +71,8 @@ void Table::startGame() {
                 std::cout << "You are still in check, please, save the King!\n";
                 continue;
             }
-            if (opponentPlayer->isInCheckMate(*board, currentPlayer)) {
+            printAllocations();
+            if (opponentPlayer->isInCheckMate()) {
                 std::cout << currentPlayer->getPlayerName() << " wins!\n";
                 break;
             }
@@ -95,15 +94,26 @@ void Table::startGame() {
                 std::cout << "You are still in check, please, save the King!\n";
                 continue;
             }
-            if (opponentPlayer->isInCheckMate(*board, currentPlayer)) {
+            if (opponentPlayer->isInCheckMate()) {
                 std::cout << currentPlayer->getPlayerName() << " wins!\n";
                 break;
             }
             std::cout << std::format("{} turn.\n",
                                      opponentPlayer->getPlayerName());
-            opponentPlayer->makeMove(AI::minimaxRoot(difficulty, *this, true),
+            const Position rootPosition{board->getPosition()};
+            const CompactMove bestMove{searchBotMove()};
+            opponentPlayer->makeMove(opponentPlayer->getLegalMove(bestMove),
                                      *board, currentPlayer);
-            if (currentPlayer->isInCheckMate(*board, opponentPlayer)) {
+            std::cout << std::format(
+                "Bot searched {} nodes and {} quiescence nodes, {:.1f}% of "
+                "the cutoffs on the first move, {:.1f}% pawn and {:.1f}% "
+                "material table hits.\n",
+                ai->getStats().nodes, ai->getStats().quiescenceNodes,
+                ai->getStats().getFirstMoveCutoffRate(),
+                ai->getStats().getPawnHitRate(),
+                ai->getStats().getMaterialHitRate());
+            printAllocations();
+            if (currentPlayer->isInCheckMate()) {
                 std::cout << opponentPlayer->getPlayerName() << " wins!\n";
                 break;
             }
@@ -111,8 +121,11 @@ void Table::startGame() {
                 std::cout << std::format(
                     "{} are in check, please, save the King!\n",
                     opponentPlayer->getPlayerName());
+            startPondering(rootPosition, bestMove);
             board->printBoard();
         }
+    // a mating move of the human leaves the pondering without a limit
+    stopPondering();
 }
 
 void Table::setGameMode() {
@@ -145,10 +158,10 @@ void Table::setGameMode() {
 
 void Table::setPlayers() {
     using enum Color::ColorT;
-    whitePlayer = std::make_unique<WhitePlayer>(
-        board->getKing(WHITE), board->calculateLegalMoves(WHITE));
-    blackPlayer = std::make_unique<BlackPlayer>(
-        board->getKing(BLACK), board->calculateLegalMoves(BLACK));
+    whitePlayer = std::make_unique<WhitePlayer>(board->getKing(WHITE));
+    blackPlayer = std::make_unique<BlackPlayer>(board->getKing(BLACK));
+    whitePlayer->updateLegalMoves(*board);
+    blackPlayer->updateLegalMoves(*board);
 }
 
 Move *Table::getPlayerTurn(Player *currentPlayer) {
@@ -190,8 +203,8 @@ Move *Table::getPlayerTurn(Player *currentPlayer) {
                     if (auto pawnPromotion(
                             dynamic_cast<PawnPromotion *>(move.get()));
                         pawnPromotion)
-                        pawnPromotion->setPromotionFigure(
-                            getPromoteFigure(pawnPromotion));
+                        pawnPromotion->setPromotionType(
+                            getPromoteFigureType());
                     return move.get();
                 }
             }
@@ -209,28 +222,78 @@ Player *Table::getOpponent(const Player *player) {
         return blackPlayer.get();
 }
 
-std::unique_ptr<Figure> Table::getPromoteFigure(const Move *move) const {
+/*
+    On a ponder hit the search goes on within the limits of the bot, counted
+    from the start of the pondering, so a move the bot expected is answered
+    at once. Any other move stops it and the bot searches again, with the
+    transposition table filled by the pondering.
+*/
+CompactMove Table::searchBotMove() {
+    const Position &position{board->getPosition()};
+    if (ponderer.joinable() && position.getKey() == ponderPosition.getKey()) {
+        ponderControl.ponderHit(false);
+        ponderer.join();
+        return ponderMove;
+    }
+    stopPondering();
+    return ai->search(position, searchLimits);
+}
+
+void Table::startPondering(const Position &rootPosition,
+                           CompactMove bestMove) {
+    const std::vector<CompactMove> principalVariation{
+        ai->getPrincipalVariation(rootPosition, bestMove)};
+    if (principalVariation.size() < 2)
+        return;
+    ponderPosition = board->getPosition();
+    ponderPosition.makeMove(principalVariation[1]);
+    ponderControl.start(true);
+    ponderer = std::jthread([this] {
+        ponderMove = ai->search(ponderPosition, searchLimits, ponderControl);
+    });
+}
+
+void Table::stopPondering() {
+    ponderControl.requestStop();
+    if (ponderer.joinable())
+        ponderer.join();
+}
+
+FigureType Table::getPromoteFigureType() const {
     std::cout << "Select the figure for pawn promotion:\n(Q)ueen, (Kn)ight, "
                  "(R)ook, (B)ishop\nInput:";
     std::string input;
-    int coordinate{move->getCoordinateToMove()};
-    Color::ColorT color{move->getMovedFigure()->getColor()};
     while (true) {
         std::getline(std::cin, input);
         if (input == "Q")
-            return std::make_unique<Queen>(coordinate, color);
+            return FigureType::QUEEN;
         else if (input == "Kn")
-            return std::make_unique<Knight>(coordinate, color);
+            return FigureType::KNIGHT;
         else if (input == "R")
-            return std::make_unique<Rook>(coordinate, color);
-
+            return FigureType::ROOK;
         else if (input == "B")
-            return std::make_unique<Bishop>(coordinate, color);
+            return FigureType::BISHOP;
         else
             std::cout << "Wrong input, please, repeat!\n";
     }
 }
 
+void Table::printAllocations() const {
+    std::size_t allocations{};
+    std::size_t allocatedBytes{};
+    std::size_t heapAllocations{};
+    for (const Player *player :
+         {static_cast<const Player *>(whitePlayer.get()),
+          static_cast<const Player *>(blackPlayer.get())}) {
+        allocations += player->getArena().getAllocations();
+        allocatedBytes += player->getArena().getAllocatedBytes();
+        heapAllocations += player->getArena().getHeapAllocations();
+    }
+    std::cout << std::format("Legal moves: {} allocations of {} bytes in the "
+                             "move arenas, {} from the heap.\n",
+                             allocations, allocatedBytes, heapAllocations);
+}
+
 void Table::setDifficulty() {
     std::cout << "Select difficulty :\n1 - easy;\n2 - normal;\nInput(number): ";
     while (true) {
@@ -238,11 +301,10 @@ void Table::setDifficulty() {
         std::cin >> input;
         switch (input) {
             case 1:
-                difficulty = 1;
+                searchLimits = EASY_LIMITS;
                 break;
             case 2:
-                difficulty = 3;
-                ;
+                searchLimits = NORMAL_LIMITS;
                 break;
             default:
                 std::cout << "Wrong input, please repeat!\n";
@@ -1,85 +1,118 @@
 #include "ai.h"
-#include "board.h"
-#include "cli.h"
-#include "figure.h"
-#include "move.h"
-#include "player.h"
+#include "move_generator.h"
+#include "nnue.h"
+#include "opening_book.h"
+#include "position.h"
+#include "search_thread.h"
+#include "tablebase.h"
+#include <algorithm>
+#include <atomic>
 #include <memory>
+#include <thread>
+#include <vector>
 
-Move *AI::minimaxRoot(int depth, Table &table, bool isMax) {
-    int bestScore{-10000};
-    Move *bestMove{};
-    for (auto &move : table.getBlackPlayer()->getLegalMoves()) {
-        auto calculationTable(std::make_unique<Table>(table));
-        Move *mirrorMove{};
-        for (auto &calculationMove :
-             calculationTable->getBlackPlayer()->getLegalMoves()) {
-            if (calculationMove->equals(*move))
-                mirrorMove = calculationMove.get();
-        }
-        if (calculationTable->getBlackPlayer()->makeMove(
-                mirrorMove, *calculationTable->getBoard(),
-                calculationTable->getWhitePlayer()) ==
-            MoveStatus::LEAVE_PLAYER_IN_CHEK)
-            continue;
-        int score =
-            minimax(depth - 1, *calculationTable, -10000, 10000, !isMax);
-        if (score >= bestScore) {
-            bestScore = score;
-            bestMove = move.get();
+AI::AI(std::size_t hashMegabytes, int threads)
+    : transpositionTable(hashMegabytes),
+      threads(threads > 0 ? threads : getDefaultThreads()) {
+}
+
+AI::~AI() = default;
+
+void AI::setOpeningBook(std::unique_ptr<OpeningBook> openingBook) {
+    this->openingBook = std::move(openingBook);
+}
+
+void AI::setTablebase(std::unique_ptr<Tablebase> tablebase) {
+    this->tablebase = std::move(tablebase);
+}
+
+void AI::setNetwork(std::unique_ptr<Nnue> network) {
+    this->network = std::move(network);
+}
+
+CompactMove AI::search(const Position &position, const SearchLimits &limits) {
+    SearchControl control;
+    control.start();
+    return search(position, limits, control);
+}
+
+CompactMove AI::search(const Position &position, const SearchLimits &limits,
+                       SearchControl &control,
+                       const IterationCallback &onIteration) {
+    if (openingBook)
+        if (const CompactMove bookMove{openingBook->probe(position)};
+            !bookMove.isNull()) {
+            stats = {};
+            return bookMove;
         }
+    transpositionTable.newSearch();
+    std::vector<std::unique_ptr<SearchThread>> searchThreads;
+    // the nodes of every thread are summed up, the helpers keep searching
+    // while the main thread reports
+    auto reportIteration{[&](int depth, int score, CompactMove bestMove) {
+        SearchInfo info{depth,
+                        score,
+                        0,
+                        control.getElapsedTime(),
+                        transpositionTable.getHashfull(),
+                        getPrincipalVariation(position, bestMove)};
+        for (const auto &searchThread : searchThreads)
+            info.nodes += searchThread->getSearchedNodes();
+        onIteration(info);
+    }};
+    for (int id{}; id < threads; id++)
+        searchThreads.push_back(std::make_unique<SearchThread>(
+            id, transpositionTable, limits, control,
+            !id && onIteration ? reportIteration
+                               : SearchThread::IterationCallback{},
+            tablebase.get(), network.get()));
+    CompactMove bestMove;
+    {
+        // the root position is only read, every thread plays on copies
+        std::vector<std::jthread> helpers;
+        for (int id{1}; id < threads; id++)
+            helpers.emplace_back([&searchThreads, &position, id] {
+                searchThreads[id]->search(position);
+            });
+        bestMove = searchThreads.front()->search(position);
     }
+    stats = {};
+    for (const auto &searchThread : searchThreads)
+        stats += searchThread->getStats();
     return bestMove;
 }
 
-int AI::minimax(int depth, Table &table, int alpha, int beta, bool isMax) {
-    if (!depth)
-        return -table.getBoard()->evaluateBoard();
-    int score{};
-    int nextScore{};
-    if (isMax) {
-        score = -10000;
-        for (auto &move : table.getBlackPlayer()->getLegalMoves()) {
-            auto calculationTable(std::make_unique<Table>(table));
-            Move *mirrorMove{};
-            for (auto &calculationMove :
-                 calculationTable->getBlackPlayer()->getLegalMoves()) {
-                if (calculationMove->equals(*move))
-                    mirrorMove = calculationMove.get();
-            }
-            if (calculationTable->getBlackPlayer()->makeMove(
-                    move.get(), *calculationTable->getBoard(),
-                    calculationTable->getWhitePlayer()) ==
-                MoveStatus::LEAVE_PLAYER_IN_CHEK)
-                continue;
-            score = std::max(score, minimax(depth - 1, *calculationTable, alpha,
-                                            beta, !isMax));
-            alpha = std::max(alpha, score);
-            if (beta <= alpha)
-                return score;
-        }
-        return score;
-    } else {
-        score = 10000;
-        for (auto &move : table.getWhitePlayer()->getLegalMoves()) {
-            auto calculationTable(std::make_unique<Table>(table));
-            Move *mirrorMove{};
-            for (auto &calculationMove :
-                 calculationTable->getWhitePlayer()->getLegalMoves()) {
-                if (calculationMove->equals(*move))
-                    mirrorMove = calculationMove.get();
-            }
-            if (calculationTable->getWhitePlayer()->makeMove(
-                    move.get(), *calculationTable->getBoard(),
-                    calculationTable->getBlackPlayer()) ==
-                MoveStatus::LEAVE_PLAYER_IN_CHEK)
-                continue;
-            score = std::min(score, minimax(depth - 1, *calculationTable, alpha,
-                                            beta, !isMax));
-            beta = std::min(beta, score);
-            if (beta <= alpha)
-                return score;
-        }
-        return score;
+std::vector<CompactMove>
+AI::getPrincipalVariation(const Position &position,
+                          CompactMove bestMove) const {
+    std::vector<CompactMove> principalVariation;
+    Position currentPosition{position};
+    TranspositionTable::Entry entry;
+    for (CompactMove move{bestMove};
+         !move.isNull() &&
+         principalVariation.size() < SearchThread::MAX_DEPTH;
+         move = transpositionTable.probe(currentPosition.getKey(), entry)
+                    ? entry.bestMove
+                    : CompactMove{}) {
+        // a hash move of another position with the same index may be stored
+        MoveList moveList;
+        MoveGenerator::generateLegalMoves(currentPosition, moveList);
+        if (!moveList.contains(move))
+            break;
+        principalVariation.push_back(move);
+        currentPosition.makeMove(move);
     }
-}
\ No newline at end of file
+    return principalVariation;
+}
+
+void AI::clear() {
+    transpositionTable.clear();
+}
+
+const SearchStats &AI::getStats() const {
+    return stats;
+}
+
+int AI::getDefaultThreads() {
+    return std::max(static_cast<int>(std::thread::hardware_concurrency()), 1);
+}
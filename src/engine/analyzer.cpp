@@ -0,0 +1,243 @@
+#include "analyzer.h"
+#include "ai.h"
+#include "epd_file.h"
+#include "fen.h"
+#include "position.h"
+#include "search_thread.h"
+#include "tablebase.h"
+#include <algorithm>
+#include <chrono>
+#include <format>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+
+Analyzer::Analyzer(int threads, const SearchLimits &limits,
+                   std::size_t hashMegabytes, const Tablebase *tablebase)
+    : limits(limits),
+      hashMegabytes(std::max<std::size_t>(hashMegabytes / threads, 1)),
+      tablebase(tablebase), queues(threads),
+      results(threads * RECORDS_PER_WORKER) {
+}
+
+bool Analyzer::takeTask(int worker, Task &task) {
+    {
+        std::unique_lock lock(mutex);
+        taskAdded.wait(lock, [this] { return pendingTasks || isFinished; });
+        if (!pendingTasks)
+            return false;
+        pendingTasks--;
+    }
+    // the claimed task is in one of the queues, the own one comes first
+    for (std::size_t i{};; i = (i + 1) % queues.size()) {
+        WorkQueue &queue{queues[(worker + i) % queues.size()]};
+        std::scoped_lock lock(queue.mutex);
+        if (queue.tasks.empty())
+            continue;
+        if (!i) {
+            task = queue.tasks.front();
+            queue.tasks.pop_front();
+        } else {
+            task = queue.tasks.back();
+            queue.tasks.pop_back();
+        }
+        return true;
+    }
+}
+
+void Analyzer::work(int worker) {
+    TranspositionTable transpositionTable(hashMegabytes);
+    for (Task task; takeTask(worker, task);) {
+        std::string line{analyzeRecord(task, transpositionTable)};
+        {
+            std::scoped_lock lock(mutex);
+            Result &result{results[task.index % results.size()]};
+            result.line = std::move(line);
+            result.isReady = true;
+        }
+        resultReady.notify_one();
+    }
+}
+
+std::string
+Analyzer::analyzeRecord(const Task &task,
+                        TranspositionTable &transpositionTable) const {
+    Position position;
+    std::string_view operations;
+    try {
+        operations = Fen::parseEpd(task.record, position);
+    } catch (const std::invalid_argument &ex) {
+        return std::format("{{\"index\":{},\"error\":\"{}\"}}", task.index,
+                           escapeJson(ex.what()));
+    }
+    transpositionTable.newSearch();
+    SearchControl control;
+    control.start();
+    const auto searchThread{std::make_unique<SearchThread>(
+        0, transpositionTable, limits, control,
+        SearchThread::IterationCallback{}, tablebase)};
+    const CompactMove bestMove{searchThread->search(position)};
+    const auto milliseconds{control.getElapsedTime().count()};
+    std::string line{std::format("{{\"index\":{},\"fen\":\"{}\"", task.index,
+                                 Fen::write(position))};
+    if (const std::string_view id{Fen::getOperation(operations, "id")};
+        !id.empty())
+        line += std::format(",\"id\":\"{}\"", escapeJson(id));
+    line += bestMove.isNull()
+                ? std::string(",\"bestmove\":null")
+                : std::format(",\"bestmove\":\"{}\"", bestMove.toString());
+    const int score{searchThread->getScore()};
+    line += SearchThread::isMateScore(score)
+                ? std::format(",\"mate\":{}", SearchThread::getMateMoves(score))
+                : std::format(",\"score\":{}", score);
+    const SearchStats &stats{searchThread->getStats()};
+    line += std::format(",\"depth\":{},\"nodes\":{},\"time_ms\":{}}}",
+                        searchThread->getCompletedDepth(),
+                        stats.nodes + stats.quiescenceNodes, milliseconds);
+    return line;
+}
+
+std::string Analyzer::escapeJson(std::string_view text) {
+    std::string escaped;
+    for (const char symbol : text) {
+        if (symbol == '"' || symbol == '\\')
+            escaped += std::format("\\{}", symbol);
+        else if (static_cast<unsigned char>(symbol) < 0x20)
+            escaped += std::format("\\u{:04x}", static_cast<int>(symbol));
+        else
+            escaped += symbol;
+    }
+    return escaped;
+}
+
+/*
+    The calling thread reads the file and deals the records to the workers
+    in turn, as long as fewer than the result slots are in flight. It then
+    waits for the oldest record and writes it, so the output keeps the order
+    of the file however the workers steal from each other.
+*/
+std::size_t Analyzer::analyze(EpdFile &epdFile, std::ostream &output) {
+    isFinished = false;
+    std::size_t dealt{};
+    std::size_t written{};
+    {
+        std::vector<std::jthread> workers;
+        for (int worker{}; worker < static_cast<int>(queues.size()); worker++)
+            workers.emplace_back(&Analyzer::work, this, worker);
+        bool isEndOfFile{};
+        while (true) {
+            std::string_view record;
+            while (!isEndOfFile && dealt - written < results.size()) {
+                isEndOfFile = !epdFile.nextLine(record);
+                if (isEndOfFile)
+                    break;
+                WorkQueue &queue{queues[dealt % queues.size()]};
+                {
+                    std::scoped_lock lock(queue.mutex);
+                    queue.tasks.push_back({dealt, record});
+                }
+                {
+                    std::scoped_lock lock(mutex);
+                    pendingTasks++;
+                }
+                taskAdded.notify_one();
+                dealt++;
+            }
+            if (written == dealt)
+                break;
+            Result &result{results[written % results.size()]};
+            std::string line;
+            {
+                std::unique_lock lock(mutex);
+                resultReady.wait(lock, [&result] { return result.isReady; });
+                line = std::move(result.line);
+                result.isReady = false;
+            }
+            output << line << '\n';
+            written++;
+        }
+        {
+            std::scoped_lock lock(mutex);
+            isFinished = true;
+        }
+        taskAdded.notify_all();
+    }
+    output.flush();
+    return written;
+}
+
+int Analyzer::run(const std::vector<std::string> &arguments) {
+    std::string inputPath;
+    std::string outputPath;
+    int threads{};
+    SearchLimits limits;
+    std::size_t hashMegabytes{TranspositionTable::DEFAULT_MEGABYTES};
+    std::string tablebaseDirectory;
+    try {
+        if (arguments.size() % 2)
+            throw std::invalid_argument("missing option value");
+        for (std::size_t i{}; i < arguments.size(); i += 2) {
+            const std::string &value{arguments[i + 1]};
+            if (arguments[i] == "--input")
+                inputPath = value;
+            else if (arguments[i] == "--output")
+                outputPath = value;
+            else if (arguments[i] == "--threads")
+                threads = std::stoi(value);
+            else if (arguments[i] == "--depth")
+                limits.maxDepth = std::stoi(value);
+            else if (arguments[i] == "--movetime")
+                limits.moveTime = std::chrono::milliseconds{std::stoll(value)};
+            else if (arguments[i] == "--nodes")
+                limits.maxNodes = std::stoull(value);
+            else if (arguments[i] == "--hash")
+                hashMegabytes = std::stoul(value);
+            else if (arguments[i] == "--tablebases")
+                tablebaseDirectory = value;
+            else
+                throw std::invalid_argument(arguments[i]);
+        }
+        if (inputPath.empty())
+            throw std::invalid_argument("missing input");
+    } catch (const std::logic_error &ex) {
+        std::cerr << "Usage: Chess analyze --input <file> [--output <file>] "
+                     "[--threads <N>] [--depth <plies>] [--movetime <ms>] "
+                     "[--nodes <N>] [--hash <MB>] [--tablebases <dir>]\n";
+        return 1;
+    }
+    if (!limits.maxDepth && !limits.moveTime.count() && !limits.maxNodes)
+        limits = DEFAULT_LIMITS;
+    limits.maxDepth = std::min(limits.maxDepth, SearchThread::MAX_DEPTH);
+    try {
+        EpdFile epdFile(inputPath);
+        std::unique_ptr<Tablebase> tablebase;
+        if (!tablebaseDirectory.empty())
+            tablebase = std::make_unique<Tablebase>(tablebaseDirectory);
+        std::ofstream outputFile;
+        if (!outputPath.empty()) {
+            outputFile.open(outputPath);
+            if (!outputFile)
+                throw std::runtime_error("Cannot write " + outputPath);
+        }
+        Analyzer analyzer(threads > 0 ? threads : AI::getDefaultThreads(),
+                          limits, hashMegabytes, tablebase.get());
+        const auto start{std::chrono::steady_clock::now()};
+        const std::size_t records{analyzer.analyze(
+            epdFile, outputPath.empty() ? std::cout : outputFile)};
+        const auto milliseconds{
+            std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::steady_clock::now() - start)
+                .count()};
+        // the summary goes to stderr, so stdout stays JSON lines
+        std::cerr << std::format(
+            "Analyzed {} positions in {} ms, {:.1f} positions per second\n",
+            records, milliseconds,
+            records * 1000.0 / std::max<long long>(milliseconds, 1));
+    } catch (const std::runtime_error &ex) {
+        std::cerr << ex.what() << '\n';
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,64 @@
+#include "arena.h"
+
+void *Arena::HeapResource::do_allocate(std::size_t bytes,
+                                       std::size_t alignment) {
+    allocations++;
+    return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+}
+
+void Arena::HeapResource::do_deallocate(void *pointer, std::size_t bytes,
+                                        std::size_t alignment) {
+    std::pmr::new_delete_resource()->deallocate(pointer, bytes, alignment);
+}
+
+bool Arena::HeapResource::do_is_equal(
+    const std::pmr::memory_resource &other) const noexcept {
+    return this == &other;
+}
+
+std::size_t Arena::HeapResource::getAllocations() const {
+    return allocations;
+}
+
+void Arena::HeapResource::resetAllocations() {
+    allocations = 0;
+}
+
+Arena::Arena(std::size_t bytes)
+    : firstBlock(bytes), buffer(firstBlock.data(), firstBlock.size(), &heap) {
+}
+
+void *Arena::do_allocate(std::size_t bytes, std::size_t alignment) {
+    allocations++;
+    allocatedBytes += bytes;
+    return buffer.allocate(bytes, alignment);
+}
+
+void Arena::do_deallocate(void *pointer, std::size_t bytes,
+                          std::size_t alignment) {
+}
+
+bool Arena::do_is_equal(
+    const std::pmr::memory_resource &other) const noexcept {
+    return this == &other;
+}
+
+// the next allocation starts over at the first block
+void Arena::release() {
+    buffer.release();
+    heap.resetAllocations();
+    allocations = 0;
+    allocatedBytes = 0;
+}
+
+std::size_t Arena::getAllocations() const {
+    return allocations;
+}
+
+std::size_t Arena::getAllocatedBytes() const {
+    return allocatedBytes;
+}
+
+std::size_t Arena::getHeapAllocations() const {
+    return heap.getAllocations();
+}
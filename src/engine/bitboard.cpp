@@ -0,0 +1,212 @@
+#include "bitboard.h"
+#include "board_utils.h"
+
+// Found once by trying sparse random numbers. A magic is valid when blocker
+// subsets with different attacks never share an index.
+const std::array<Bitboard, BoardUtils::NUMBER_SQUARES>
+    BitboardUtils::BISHOP_MAGICS = {
+        0x48081010008A2A80, 0x000948110C0B2081, 0x0944140400500000,
+        0x4984104A00000101, 0x4004030818283008, 0x0206012462000121,
+        0x1A02013008040001, 0x0001008044200440, 0x0000312208080880,
+        0x0220021002009900, 0x8080880801082000, 0x000C11040080102A,
+        0x1402440421000210, 0x0010120802080A81, 0x0080084202104028,
+        0x1100002082082082, 0x0008403429080820, 0x8104868204040412,
+        0x6424084043060030, 0x1108000420401000, 0x9004101202020240,
+        0x0032400608200412, 0x0001009610822080, 0x0008403429080820,
+        0x0008068340104200, 0x0010102858090121, 0x81004C0018080313,
+        0x4048080004820002, 0x000900401C004049, 0x0009420121C1101C,
+        0x4828504005040211, 0x4828504005040211, 0x0041041381202000,
+        0x01008C1005601680, 0x01D010900002040A, 0x4040020080080080,
+        0x4801080200802200, 0x4801080200802200, 0x0010046108108080,
+        0x90409090810A0220, 0x8004020242201020, 0x8004020242201020,
+        0x0202010028020480, 0x0000041144000801, 0x00002000A4021080,
+        0x0504090045040200, 0x8182041102094400, 0x0550008100480101,
+        0xC002080404040400, 0x0382004108292000, 0x12000100A8040020,
+        0xA005020442088020, 0x2000001102020300, 0x000021E0420C8808,
+        0x3060200484888400, 0x01280101021A0802, 0x1030820110010500,
+        0x0080012608025800, 0x0002810084008800, 0x800080000C208800,
+        0xA408002140028204, 0x0010006020322084, 0x0210401044110050,
+        0x40106000A1160020};
+const std::array<Bitboard, BoardUtils::NUMBER_SQUARES>
+    BitboardUtils::ROOK_MAGICS = {
+        0x0480046281400010, 0x80C0200010004000, 0x8780200008300180,
+        0x8880060800100080, 0x2100030010080084, 0x0100040001000802,
+        0x0200040800810200, 0x0580008002407100, 0x1000800080400020,
+        0x0080401000402001, 0x800C802002100880, 0x800A002200884010,
+        0x2046002008108600, 0x0222009002000804, 0x100B000421001200,
+        0x0240800100004080, 0x4540008020408006, 0x8010054020084002,
+        0x7D10010100200040, 0x1408008010000882, 0x4408010005000810,
+        0x001E008004000280, 0x0230040001080210, 0x0000020004004081,
+        0x0100400080208001, 0x1000842300400100, 0x1060100080200082,
+        0x3219004B00100020, 0x9010080080800400, 0x8440020080800400,
+        0x6008010080800200, 0x4123008200010044, 0x0280002001400240,
+        0x0220100040400020, 0x0060801003802008, 0x0008100080800800,
+        0x0105000801001004, 0x100B000803000400, 0x0000024814001021,
+        0x00408000C2802100, 0x4C40004020808002, 0x4410500420024000,
+        0x00C0100020008080, 0x0000100008008080, 0x8002000804220011,
+        0x0802000804010100, 0x0243100201040008, 0x0000009100420014,
+        0x1000400280022480, 0x0020200040100040, 0x00A000100800C140,
+        0x0410001408008080, 0x0000080004008080, 0x0100020004008080,
+        0x0303000200040300, 0x1480006104008200, 0x00008002204A1101,
+        0x1040090010224081, 0x4300C0200011000D, 0x8002041001002009,
+        0x2005000800020411, 0x110A008408100102, 0x0006000108008402,
+        0x0200002900884402};
+const BitboardUtils::MagicTable BitboardUtils::BISHOP_TABLE =
+    initMagicTable(BISHOP_DIRECTIONS, BISHOP_MAGICS);
+const BitboardUtils::MagicTable BitboardUtils::ROOK_TABLE =
+    initMagicTable(ROOK_DIRECTIONS, ROOK_MAGICS);
+const std::array<Bitboard, BoardUtils::NUMBER_SQUARES>
+    BitboardUtils::KNIGHT_ATTACKS = initLeaperAttacks(KNIGHT_STEPS);
+const std::array<Bitboard, BoardUtils::NUMBER_SQUARES>
+    BitboardUtils::KING_ATTACKS = initLeaperAttacks(KING_STEPS);
+const std::array<std::array<Bitboard, BoardUtils::NUMBER_SQUARES>, 2>
+    BitboardUtils::PAWN_ATTACKS = {initLeaperAttacks(BLACK_PAWN_STEPS),
+                                   initLeaperAttacks(WHITE_PAWN_STEPS)};
+const BitboardUtils::SquarePairTable BitboardUtils::BETWEEN =
+    initSquarePairTable(false);
+const BitboardUtils::SquarePairTable BitboardUtils::LINES =
+    initSquarePairTable(true);
+
+Bitboard BitboardUtils::getKnightAttacks(int coordinate) {
+    return KNIGHT_ATTACKS[coordinate];
+}
+
+Bitboard BitboardUtils::getKingAttacks(int coordinate) {
+    return KING_ATTACKS[coordinate];
+}
+
+Bitboard BitboardUtils::getPawnAttacks(Color::ColorT color, int coordinate) {
+    return PAWN_ATTACKS[static_cast<int>(color)][coordinate];
+}
+
+Bitboard BitboardUtils::getBetween(int coordinate, int otherCoordinate) {
+    return BETWEEN[coordinate][otherCoordinate];
+}
+
+Bitboard BitboardUtils::getLine(int coordinate, int otherCoordinate) {
+    return LINES[coordinate][otherCoordinate];
+}
+
+Bitboard BitboardUtils::getBishopAttacks(int coordinate, Bitboard occupancy) {
+    return getAttacks(BISHOP_TABLE, coordinate, occupancy);
+}
+
+Bitboard BitboardUtils::getRookAttacks(int coordinate, Bitboard occupancy) {
+    return getAttacks(ROOK_TABLE, coordinate, occupancy);
+}
+
+Bitboard BitboardUtils::getQueenAttacks(int coordinate, Bitboard occupancy) {
+    return getBishopAttacks(coordinate, occupancy) |
+           getRookAttacks(coordinate, occupancy);
+}
+
+Bitboard BitboardUtils::getAttacks(const MagicTable &table, int coordinate,
+                                   Bitboard occupancy) {
+    const Magic &magic{table.magics[coordinate]};
+    return table.attacks[magic.offset + ((occupancy & magic.mask) *
+                                         magic.magic >> magic.shift)];
+}
+
+Bitboard BitboardUtils::calculateRay(int coordinate, Bitboard occupancy,
+                                     int rowStep, int columnStep,
+                                     bool excludeEdges) {
+    constexpr int rowSize{BoardUtils::NUMBER_SQUARE_PER_ROW};
+    auto isOnBoard{[](int row, int column) {
+        return row >= 0 && row < rowSize && column >= 0 && column < rowSize;
+    }};
+    Bitboard ray{};
+    int row{coordinate / rowSize + rowStep};
+    int column{coordinate % rowSize + columnStep};
+    for (; isOnBoard(row, column); row += rowStep, column += columnStep) {
+        // a blocker on the last square of a ray never shortens it
+        if (excludeEdges && !isOnBoard(row + rowStep, column + columnStep))
+            break;
+        const int candidateCoordinate{row * rowSize + column};
+        ray |= squareBit(candidateCoordinate);
+        if (isSet(occupancy, candidateCoordinate))
+            break;
+    }
+    return ray;
+}
+
+Bitboard BitboardUtils::calculateRayAttacks(int coordinate, Bitboard occupancy,
+                                            const Directions &directions,
+                                            bool excludeEdges) {
+    Bitboard attacks{};
+    for (const auto &[rowStep, columnStep] : directions)
+        attacks |= calculateRay(coordinate, occupancy, rowStep, columnStep,
+                                excludeEdges);
+    return attacks;
+}
+
+BitboardUtils::SquarePairTable BitboardUtils::initSquarePairTable(bool isLine) {
+    SquarePairTable table{};
+    for (int coordinate{}; coordinate < BoardUtils::NUMBER_SQUARES;
+         coordinate++)
+        for (const Directions *directions :
+             {&BISHOP_DIRECTIONS, &ROOK_DIRECTIONS})
+            for (const auto &[rowStep, columnStep] : *directions) {
+                const Bitboard ray{
+                    calculateRay(coordinate, EMPTY, rowStep, columnStep, false)};
+                const Bitboard line{ray | squareBit(coordinate) |
+                                    calculateRay(coordinate, EMPTY, -rowStep,
+                                                 -columnStep, false)};
+                for (Bitboard targets{ray}; targets;) {
+                    const int otherCoordinate{popLsb(targets)};
+                    const Bitboard otherBit{squareBit(otherCoordinate)};
+                    table[coordinate][otherCoordinate] =
+                        isLine ? line
+                               : calculateRay(coordinate, otherBit, rowStep,
+                                              columnStep, false) &
+                                     ~otherBit;
+                }
+            }
+    return table;
+}
+
+BitboardUtils::MagicTable BitboardUtils::initMagicTable(
+    const Directions &directions,
+    const std::array<Bitboard, BoardUtils::NUMBER_SQUARES> &magics) {
+    MagicTable table;
+    for (int coordinate{}; coordinate < BoardUtils::NUMBER_SQUARES;
+         coordinate++) {
+        Magic &magic{table.magics[coordinate]};
+        magic.mask = calculateRayAttacks(coordinate, EMPTY, directions, true);
+        magic.magic = magics[coordinate];
+        magic.shift = 64 - popCount(magic.mask);
+        magic.offset = static_cast<int>(table.attacks.size());
+        table.attacks.resize(magic.offset + (1 << popCount(magic.mask)));
+        // every subset of the mask, enumerated with the carry-rippler trick
+        Bitboard subset{};
+        do {
+            const auto index{subset * magic.magic >> magic.shift};
+            table.attacks[magic.offset + index] =
+                calculateRayAttacks(coordinate, subset, directions, false);
+            subset = (subset - magic.mask) & magic.mask;
+        } while (subset);
+    }
+    return table;
+}
+
+template <std::size_t N>
+std::array<Bitboard, BoardUtils::NUMBER_SQUARES>
+BitboardUtils::initLeaperAttacks(const Steps<N> &steps) {
+    std::array<Bitboard, BoardUtils::NUMBER_SQUARES> attacks{};
+    for (int coordinate{}; coordinate < BoardUtils::NUMBER_SQUARES;
+         coordinate++) {
+        const int row{coordinate / BoardUtils::NUMBER_SQUARE_PER_ROW};
+        const int column{coordinate % BoardUtils::NUMBER_SQUARE_PER_ROW};
+        for (const auto &[rowStep, columnStep] : steps) {
+            const int candidateRow{row + rowStep};
+            const int candidateColumn{column + columnStep};
+            if (candidateRow >= 0 &&
+                candidateRow < BoardUtils::NUMBER_SQUARE_PER_ROW &&
+                candidateColumn >= 0 &&
+                candidateColumn < BoardUtils::NUMBER_SQUARE_PER_ROW)
+                attacks[coordinate] |= squareBit(
+                    candidateRow * BoardUtils::NUMBER_SQUARE_PER_ROW +
+                    candidateColumn);
+        }
+    }
+    return attacks;
+}
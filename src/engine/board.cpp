@@ -1,9 +1,11 @@
 #include "board.h"
+#include "fen.h"
 #include "figure.h"
 #include "figure_type.h"
 #include "move.h"
 #include <format>
 #include <iostream>
+#include <stdexcept>
 
 Square::Square(int coordinate) : coordinate(coordinate) {
 }
@@ -38,10 +40,6 @@ bool Square::isSquareOccupied() const {
     return !(figureOnSquare == nullptr);
 }
 
-void Board::setFigureOnBoard(std::unique_ptr<Figure> figure) {
-    board[figure->getCoordinate()]->setFigureOnSquare(std::move(figure));
-}
-
 Board::Board() {
     int cnt{};
     for (auto &square : board) {
@@ -82,16 +80,81 @@ Board::Board() {
     setFigureOnBoard(std::make_unique<Bishop>(61, Color::ColorT::WHITE));
     setFigureOnBoard(std::make_unique<Knight>(62, Color::ColorT::WHITE));
     setFigureOnBoard(std::make_unique<Rook>(63, Color::ColorT::WHITE));
+    updateCastlingRights();
 }
 
-Board::Board(const Board &board) {
+/*
+    Places the figures of a parsed FEN record. Castling rights are kept in the
+    first-move flags of the king and rooks, Fen::parse already dropped the
+    rights whose king and rook are not on their initial squares.
+*/
+Board::Board(const std::string &fen) {
+    int cnt{};
+    for (auto &square : board) {
+        square = std::make_unique<Square>(cnt);
+        cnt++;
+    }
+    Position parsedPosition;
+    Fen::parse(fen, parsedPosition);
+    for (Bitboard occupied{parsedPosition.getOccupancy()}; occupied;) {
+        const int coordinate{BitboardUtils::popLsb(occupied)};
+        setFigureOnBoard(createFigure(parsedPosition.getFigureType(coordinate),
+                                      parsedPosition.getColor(coordinate),
+                                      coordinate));
+    }
+    position.setSideToMove(parsedPosition.getSideToMove());
+    position.setHalfmoveClock(parsedPosition.getHalfmoveClock());
+    position.setFullmoveNumber(parsedPosition.getFullmoveNumber());
+    const int castlingRights{parsedPosition.getCastlingRights()};
+    for (const auto color : {Color::ColorT::WHITE, Color::ColorT::BLACK}) {
+        for (auto king : getFigures(color, FigureType::KING))
+            king->setFirstMove(
+                (king->getCoordinate() == 60 &&
+                 (castlingRights & (Position::WHITE_KING_SIDE |
+                                    Position::WHITE_QUEEN_SIDE))) ||
+                (king->getCoordinate() == 4 &&
+                 (castlingRights & (Position::BLACK_KING_SIDE |
+                                    Position::BLACK_QUEEN_SIDE))));
+        for (auto rook : getFigures(color, FigureType::ROOK))
+            rook->setFirstMove(
+                (rook->getCoordinate() == 63 &&
+                 (castlingRights & Position::WHITE_KING_SIDE)) ||
+                (rook->getCoordinate() == 56 &&
+                 (castlingRights & Position::WHITE_QUEEN_SIDE)) ||
+                (rook->getCoordinate() == 7 &&
+                 (castlingRights & Position::BLACK_KING_SIDE)) ||
+                (rook->getCoordinate() == 0 &&
+                 (castlingRights & Position::BLACK_QUEEN_SIDE)));
+    }
+    if (const int enPassantCoordinate{
+            parsedPosition.getEnPassantCoordinate()};
+        enPassantCoordinate >= 0)
+        setEnPassantPawn(static_cast<Pawn *>(
+            board[enPassantCoordinate +
+                  Color::getOppositeDirection(position.getSideToMove()) *
+                      BoardUtils::NUMBER_SQUARE_PER_ROW]
+                ->getFigureOnSquare()));
+    updateCastlingRights();
+}
+
+Board::Board(const Board &board) : position(board.position) {
     for (int i{}; i < BoardUtils::NUMBER_SQUARES; i++) {
         this->board[i] = std::make_unique<Square>(*board.board[i]);
+        if (Figure *figure{this->board[i]->getFigureOnSquare()})
+            addToFigureList(figure, i);
     }
+    if (board.enPassantPawn)
+        enPassantPawn = static_cast<Pawn *>(
+            getSquare(board.enPassantPawn->getCoordinate())
+                ->getFigureOnSquare());
 }
 
 void Board::setEnPassantPawn(Pawn *pawn) {
     enPassantPawn = pawn;
+    position.setEnPassantCoordinate(
+        pawn ? pawn->getCoordinate() - Color::getDirection(pawn->getColor()) *
+                                           BoardUtils::NUMBER_SQUARE_PER_ROW
+             : -1);
 }
 
 Pawn *Board::getEnPassantPawn() {
@@ -102,26 +165,147 @@ Board &Board::operator=(Board &&board) noexcept {
     if (&board == this)
         return *this;
     this->board = std::move(board.board);
+    this->figureLists = board.figureLists;
+    this->listIndices = board.listIndices;
+    this->position = board.position;
     this->enPassantPawn = board.enPassantPawn;
     return *this;
 }
 
-std::vector<Figure *> Board::getActiveFigures() {
-    std::vector<Figure *> figures;
-    for (auto &square : board)
-        if (square->isSquareOccupied())
-            figures.push_back(square->getFigureOnSquare());
-    return figures;
+void Board::updateCastlingRights() {
+    auto hasRight{[this](int kingCoordinate, int rookCoordinate,
+                         Color::ColorT color) {
+        const Figure *king{board[kingCoordinate]->getFigureOnSquare()};
+        const Figure *rook{board[rookCoordinate]->getFigureOnSquare()};
+        return king && king->getFigureType() == FigureType::KING &&
+               king->getColor() == color && king->isFirstMove() && rook &&
+               rook->getFigureType() == FigureType::ROOK &&
+               rook->getColor() == color && rook->isFirstMove();
+    }};
+    using enum Color::ColorT;
+    position.setCastlingRights(
+        (hasRight(60, 63, WHITE) ? Position::WHITE_KING_SIDE : 0) |
+        (hasRight(60, 56, WHITE) ? Position::WHITE_QUEEN_SIDE : 0) |
+        (hasRight(4, 7, BLACK) ? Position::BLACK_KING_SIDE : 0) |
+        (hasRight(4, 0, BLACK) ? Position::BLACK_QUEEN_SIDE : 0));
 }
 
-std::vector<Figure *> Board::getActiveFigures(Color::ColorT color) {
-    std::vector<Figure *> figures;
-    for (auto &square : board) {
-        if (square->isSquareOccupied() &&
-            square->getFigureOnSquare()->getColor() == color)
-            figures.push_back(square->getFigureOnSquare());
+std::unique_ptr<Figure> Board::createFigure(FigureType figureType,
+                                            Color::ColorT color,
+                                            int coordinate) {
+    switch (figureType) {
+        case FigureType::KING:
+            return std::make_unique<King>(coordinate, color);
+        case FigureType::QUEEN:
+            return std::make_unique<Queen>(coordinate, color);
+        case FigureType::ROOK:
+            return std::make_unique<Rook>(coordinate, color);
+        case FigureType::KNIGHT:
+            return std::make_unique<Knight>(coordinate, color);
+        case FigureType::BISHOP:
+            return std::make_unique<Bishop>(coordinate, color);
+        case FigureType::PAWN:
+            return std::make_unique<Pawn>(coordinate, color);
+    }
+    return nullptr;
+}
+
+Board::FigureList &Board::getFigureList(const Figure &figure) {
+    return figureLists[static_cast<int>(figure.getColor())]
+                      [static_cast<int>(figure.getFigureType())];
+}
+
+void Board::addToFigureList(Figure *figure, int coordinate) {
+    FigureList &list{getFigureList(*figure)};
+    listIndices[coordinate] = list.size;
+    list.figures[list.size++] = figure;
+}
+
+// figures leave the board between the steps of a move, when the coordinate
+// of each figure on it is its square
+void Board::removeFromFigureList(const Figure &figure, int coordinate) {
+    FigureList &list{getFigureList(figure)};
+    Figure *last{list.figures[--list.size]};
+    list.figures[listIndices[coordinate]] = last;
+    listIndices[last->getCoordinate()] = listIndices[coordinate];
+}
+
+const Position &Board::getPosition() const {
+    return position;
+}
+
+void Board::setFigureOnBoard(std::unique_ptr<Figure> figure) {
+    const int coordinate{figure->getCoordinate()};
+    if (position.isOccupied(coordinate)) {
+        position.removeFigure(coordinate);
+        removeFromFigureList(*board[coordinate]->getFigureOnSquare(),
+                             coordinate);
     }
-    return figures;
+    position.addFigure(figure->getFigureType(), figure->getColor(),
+                       coordinate);
+    addToFigureList(figure.get(), coordinate);
+    board[coordinate]->setFigureOnSquare(std::move(figure));
+}
+
+std::unique_ptr<Figure> Board::removeFigure(int coordinate) {
+    position.removeFigure(coordinate);
+    removeFromFigureList(*board[coordinate]->getFigureOnSquare(), coordinate);
+    return board[coordinate]->releaseFigure();
+}
+
+void Board::moveFigure(int coordinate, int coordinateToMove) {
+    position.moveFigure(coordinate, coordinateToMove);
+    listIndices[coordinateToMove] = listIndices[coordinate];
+    board[coordinateToMove]->setFigureOnSquare(
+        board[coordinate]->releaseFigure());
+}
+
+MoveUndo Board::makeMove(const Move &move) {
+#ifdef CHESS_VERIFY_HASH
+    Position expectedPosition{position};
+    expectedPosition.makeMove(move.toCompactMove());
+#endif
+    MoveUndo undo;
+    undo.enPassantPawn = enPassantPawn;
+    undo.castlingRights = position.getCastlingRights();
+    undo.halfmoveClock = position.getHalfmoveClock();
+    const bool isIrreversible{position.isIrreversible(move.toCompactMove())};
+    setEnPassantPawn(nullptr);
+    move.make(*this, undo);
+    if (undo.castlingRights)
+        updateCastlingRights();
+    position.setHalfmoveClock(isIrreversible ? 0 : undo.halfmoveClock + 1);
+    if (position.getSideToMove() == Color::ColorT::BLACK)
+        position.setFullmoveNumber(position.getFullmoveNumber() + 1);
+    position.setSideToMove(Color::getOppositeColor(position.getSideToMove()));
+#ifdef CHESS_VERIFY_HASH
+    if (position.getKey() != position.calculateKey())
+        throw std::logic_error("Zobrist key out of sync after makeMove");
+    if (position != expectedPosition)
+        throw std::logic_error("Position::makeMove differs from Board");
+#endif
+    return undo;
+}
+
+void Board::unmakeMove(const Move &move, MoveUndo &undo) {
+    move.unmake(*this, undo);
+    setEnPassantPawn(undo.enPassantPawn);
+    position.setCastlingRights(undo.castlingRights);
+    position.setHalfmoveClock(undo.halfmoveClock);
+    position.setSideToMove(Color::getOppositeColor(position.getSideToMove()));
+    if (position.getSideToMove() == Color::ColorT::BLACK)
+        position.setFullmoveNumber(position.getFullmoveNumber() - 1);
+#ifdef CHESS_VERIFY_HASH
+    if (position.getKey() != position.calculateKey())
+        throw std::logic_error("Zobrist key out of sync after unmakeMove");
+#endif
+}
+
+std::span<Figure *const> Board::getFigures(Color::ColorT color,
+                                           FigureType figureType) const {
+    const FigureList &list{figureLists[static_cast<int>(color)]
+                                      [static_cast<int>(figureType)]};
+    return {list.figures.data(), static_cast<std::size_t>(list.size)};
 }
 
 Square *Board::getSquare(int coordinate) {
@@ -132,22 +316,18 @@ const Square *Board::getSquare(int coordinate) const {
     return board[coordinate].get();
 }
 
-std::vector<std::unique_ptr<Move>>
-Board::calculateLegalMoves(Color::ColorT playerColor) {
-    std::vector<std::unique_ptr<Move>> moves;
-    for (auto &figure : getActiveFigures(playerColor)) {
-        auto calculated{figure->calculateLegalMoves(*this)};
-        for (auto &move : calculated)
-            moves.push_back(std::move(move));
-    }
+MoveVector Board::calculateLegalMoves(Color::ColorT playerColor,
+                                      Arena &arena) {
+    MoveVector moves(&arena);
+    for (const auto &list : figureLists[static_cast<int>(playerColor)])
+        for (int i{}; i < list.size; i++)
+            list.figures[i]->calculateLegalMoves(*this, arena, moves);
     return moves;
 }
 
 King *Board::getKing(Color::ColorT color) {
-    for (auto figure : getActiveFigures(color))
-        if (figure->getFigureType() == FigureType::KING)
-            return dynamic_cast<King *>(figure);
-    return nullptr;
+    const auto kings{getFigures(color, FigureType::KING)};
+    return kings.empty() ? nullptr : static_cast<King *>(kings.front());
 }
 
 /*
@@ -202,13 +382,10 @@ void Board::printBoard() const {
     }
 }
 
-int Board::evaluateBoard() {
-    int score{};
-    for (auto figures(getActiveFigures(Color::ColorT::WHITE));
-         auto &figure : figures)
-        score += figure->getValue();
-    for (auto figures(getActiveFigures(Color::ColorT::BLACK));
-         auto &figure : figures)
-        score -= figure->getValue();
-    return score;
+bool Board::isSquareAttacked(int coordinate, Color::ColorT byColor) const {
+    return position.isSquareAttacked(coordinate, byColor);
+}
+
+Bitboard Board::attackersTo(int coordinate) const {
+    return position.attackersTo(coordinate, position.getOccupancy());
 }
\ No newline at end of file
@@ -1,4 +1,5 @@
 #include "board_utils.h"
+#include <stdexcept>
 
 const std::array<bool, BoardUtils::NUMBER_SQUARES> BoardUtils::EIGHTH_RANK =
     initRow(0);
@@ -32,11 +33,20 @@ const std::array<std::string, BoardUtils::NUMBER_SQUARES>
         "b4", "c4", "d4", "e4", "f4", "g4", "h4", "a3", "b3", "c3", "d3",
         "e3", "f3", "g3", "h3", "a2", "b2", "c2", "d2", "e2", "f2", "g2",
         "h2", "a1", "b1", "c1", "d1", "e1", "f1", "g1", "h1"};
-const std::map<std::string, int> BoardUtils::POSITION_TO_COORDINATE =
-    initializePositionToCoordinate();
 
-int BoardUtils::getCoordinateAtPosition(const std::string &position) {
-    return POSITION_TO_COORDINATE.at(position);
+int BoardUtils::getCoordinateAtPosition(std::string_view position) {
+    const int coordinate{parseCoordinate(position)};
+    if (coordinate < 0)
+        throw std::out_of_range("Invalid square: " + std::string(position));
+    return coordinate;
+}
+
+// rank 8 is row 0, so the row counts down from the rank
+int BoardUtils::parseCoordinate(std::string_view position) {
+    if (position.size() != 2 || position[0] < 'a' || position[0] > 'h' ||
+        position[1] < '1' || position[1] > '8')
+        return -1;
+    return ('8' - position[1]) * NUMBER_SQUARE_PER_ROW + (position[0] - 'a');
 }
 
 std::string BoardUtils::getPositionAtCoordinate(int coordinate) {
@@ -64,12 +74,4 @@ BoardUtils::initColumn(int colNumber) {
         colNumber += NUMBER_SQUARE_PER_ROW;
     } while (colNumber < NUMBER_SQUARES);
     return column;
-}
-
-std::map<std::string, int> BoardUtils::initializePositionToCoordinate() {
-    std::map<std::string, int> positionToCoordinate;
-    for (int i{0}; i < NUMBER_SQUARES; i++) {
-        positionToCoordinate[ALGEBRAIC_NOTATION[i]] = i;
-    }
-    return positionToCoordinate;
 }
\ No newline at end of file
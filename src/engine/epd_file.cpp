@@ -0,0 +1,68 @@
+#include "epd_file.h"
+#include <fcntl.h>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+EpdFile::EpdFile(const std::string &path) {
+    const int descriptor{open(path.c_str(), O_RDONLY)};
+    if (descriptor < 0)
+        throw std::runtime_error("Cannot open " + path);
+    struct stat status {};
+    if (fstat(descriptor, &status) < 0) {
+        close(descriptor);
+        throw std::runtime_error("Cannot read " + path);
+    }
+    size = static_cast<std::size_t>(status.st_size);
+    // an empty file cannot be mapped and has no lines anyway
+    if (size) {
+        void *mapping{
+            mmap(nullptr, size, PROT_READ, MAP_PRIVATE, descriptor, 0)};
+        if (mapping == MAP_FAILED) {
+            close(descriptor);
+            throw std::runtime_error("Cannot map " + path);
+        }
+        madvise(mapping, size, MADV_SEQUENTIAL);
+        data = static_cast<const char *>(mapping);
+    }
+    // the mapping stays valid after the descriptor is closed
+    close(descriptor);
+}
+
+EpdFile::~EpdFile() {
+    if (data)
+        munmap(const_cast<char *>(data), size);
+}
+
+void EpdFile::releaseReadPages() {
+    const std::size_t pageSize{static_cast<std::size_t>(sysconf(_SC_PAGESIZE))};
+    const std::size_t releasedEnd{offset / pageSize * pageSize};
+    if (releasedEnd > releasedSize)
+        madvise(const_cast<char *>(data) + releasedSize,
+                releasedEnd - releasedSize, MADV_DONTNEED);
+    releasedSize = releasedEnd;
+}
+
+bool EpdFile::nextLine(std::string_view &line) {
+    const std::string_view contents{data, size};
+    if (offset - releasedSize >= RELEASE_SIZE)
+        releaseReadPages();
+    while (offset < size) {
+        std::size_t end{contents.find('\n', offset)};
+        if (end == std::string_view::npos)
+            end = size;
+        line = contents.substr(offset, end - offset);
+        offset = end + 1;
+        if (!line.empty() && line.back() == '\r')
+            line.remove_suffix(1);
+        const std::size_t first{line.find_first_not_of(" \t")};
+        if (first != std::string_view::npos && line[first] != '#')
+            return true;
+    }
+    return false;
+}
+
+std::size_t EpdFile::getSize() const {
+    return size;
+}
@@ -0,0 +1,325 @@
+#include "evaluation.h"
+#include "position.h"
+#include <cstdlib>
+
+// by figure type, from white's point of view with a8 first
+const Evaluation::SquareTables Evaluation::MIDDLEGAME_SQUARES{{
+    // king
+    { -65,   23,   16,  -15,  -56,  -34,    2,   13,
+       29,   -1,  -20,   -7,   -8,   -4,  -38,  -29,
+       -9,   24,    2,  -16,  -20,    6,   22,  -22,
+      -17,  -20,  -12,  -27,  -30,  -25,  -14,  -36,
+      -49,   -1,  -27,  -39,  -46,  -44,  -33,  -51,
+      -14,  -14,  -22,  -46,  -44,  -30,  -15,  -27,
+        1,    7,   -8,  -64,  -43,  -16,    9,    8,
+      -15,   36,   12,  -54,    8,  -28,   24,   14},
+    // queen
+    { -28,    0,   29,   12,   59,   44,   43,   45,
+      -24,  -39,   -5,    1,  -16,   57,   28,   54,
+      -13,  -17,    7,    8,   29,   56,   47,   57,
+      -27,  -27,  -16,  -16,   -1,   17,   -2,    1,
+       -9,  -26,   -9,  -10,   -2,   -4,    3,   -3,
+      -14,    2,  -11,   -2,   -5,    2,   14,    5,
+      -35,   -8,   11,    2,    8,   15,   -3,    1,
+       -1,  -18,   -9,   10,  -15,  -25,  -31,  -50},
+    // rook
+    {  32,   42,   32,   51,   63,    9,   31,   43,
+       27,   32,   58,   62,   80,   67,   26,   44,
+       -5,   19,   26,   36,   17,   45,   61,   16,
+      -24,  -11,    7,   26,   24,   35,   -8,  -20,
+      -36,  -26,  -12,   -1,    9,   -7,    6,  -23,
+      -45,  -25,  -16,  -17,    3,    0,   -5,  -33,
+      -44,  -16,  -20,   -9,   -1,   11,   -6,  -71,
+      -19,  -13,    1,   17,   16,    7,  -37,  -26},
+    // knight
+    {-167,  -89,  -34,  -49,   61,  -97,  -15, -107,
+      -73,  -41,   72,   36,   23,   62,    7,  -17,
+      -47,   60,   37,   65,   84,  129,   73,   44,
+       -9,   17,   19,   53,   37,   69,   18,   22,
+      -13,    4,   16,   13,   28,   19,   21,   -8,
+      -23,   -9,   12,   10,   19,   17,   25,  -16,
+      -29,  -53,  -12,   -3,   -1,   18,  -14,  -19,
+     -105,  -21,  -58,  -33,  -17,  -28,  -19,  -23},
+    // bishop
+    { -29,    4,  -82,  -37,  -25,  -42,    7,   -8,
+      -26,   16,  -18,  -13,   30,   59,   18,  -47,
+      -16,   37,   43,   40,   35,   50,   37,   -2,
+       -4,    5,   19,   50,   37,   37,    7,   -2,
+       -6,   13,   13,   26,   34,   12,   10,    4,
+        0,   15,   15,   15,   14,   27,   18,   10,
+        4,   15,   16,    0,    7,   21,   33,    1,
+      -33,   -3,  -14,  -21,  -13,  -12,  -39,  -21},
+    // pawn
+    {   0,    0,    0,    0,    0,    0,    0,    0,
+       98,  134,   61,   95,   68,  126,   34,  -11,
+       -6,    7,   26,   31,   65,   56,   25,  -20,
+      -14,   13,    6,   21,   23,   12,   17,  -23,
+      -27,   -2,   -5,   12,   17,    6,   10,  -25,
+      -26,   -4,   -4,  -10,    3,    3,   33,  -12,
+      -35,   -1,  -20,  -23,  -15,   24,   38,  -22,
+        0,    0,    0,    0,    0,    0,    0,    0},
+}};
+
+const Evaluation::SquareTables Evaluation::ENDGAME_SQUARES{{
+    // king
+    { -74,  -35,  -18,  -18,  -11,   15,    4,  -17,
+      -12,   17,   14,   17,   17,   38,   23,   11,
+       10,   17,   23,   15,   20,   45,   44,   13,
+       -8,   22,   24,   27,   26,   33,   26,    3,
+      -18,   -4,   21,   24,   27,   23,    9,  -11,
+      -19,   -3,   11,   21,   23,   16,    7,   -9,
+      -27,  -11,    4,   13,   14,    4,   -5,  -17,
+      -53,  -34,  -21,  -11,  -28,  -14,  -24,  -43},
+    // queen
+    {  -9,   22,   22,   27,   27,   19,   10,   20,
+      -17,   20,   32,   41,   58,   25,   30,    0,
+      -20,    6,    9,   49,   47,   35,   19,    9,
+        3,   22,   24,   45,   57,   40,   57,   36,
+      -18,   28,   19,   47,   31,   34,   39,   23,
+      -16,  -27,   15,    6,    9,   17,   10,    5,
+      -22,  -23,  -30,  -16,  -16,  -23,  -36,  -32,
+      -33,  -28,  -22,  -43,   -5,  -32,  -20,  -41},
+    // rook
+    {  13,   10,   18,   15,   12,   12,    8,    5,
+       11,   13,   13,   11,   -3,    3,    8,    3,
+        7,    7,    7,    5,    4,   -3,   -5,   -3,
+        4,    3,   13,    1,    2,    1,   -1,    2,
+        3,    5,    8,    4,   -5,   -6,   -8,  -11,
+       -4,    0,   -5,   -1,   -7,  -12,   -8,  -16,
+       -6,   -6,    0,    2,   -9,   -9,  -11,   -3,
+       -9,    2,    3,   -1,   -5,  -13,    4,  -20},
+    // knight
+    { -58,  -38,  -13,  -28,  -31,  -27,  -63,  -99,
+      -25,   -8,  -25,   -2,   -9,  -25,  -24,  -52,
+      -24,  -20,   10,    9,   -1,   -9,  -19,  -41,
+      -17,    3,   22,   22,   22,   11,    8,  -18,
+      -18,   -6,   16,   25,   16,   17,    4,  -18,
+      -23,   -3,   -1,   15,   10,   -3,  -20,  -22,
+      -42,  -20,  -10,   -5,   -2,  -20,  -23,  -44,
+      -29,  -51,  -23,  -15,  -22,  -18,  -50,  -64},
+    // bishop
+    { -14,  -21,  -11,   -8,   -7,   -9,  -17,  -24,
+       -8,   -4,    7,  -12,   -3,  -13,   -4,  -14,
+        2,   -8,    0,   -1,   -2,    6,    0,    4,
+       -3,    9,   12,    9,   14,   10,    3,    2,
+       -6,    3,   13,   19,    7,   10,   -3,   -9,
+      -12,   -3,    8,   10,   13,    3,   -7,  -15,
+      -14,  -18,   -7,   -1,    4,   -9,  -15,  -27,
+      -23,   -9,  -23,   -5,   -9,  -16,   -5,  -17},
+    // pawn
+    {   0,    0,    0,    0,    0,    0,    0,    0,
+      178,  173,  158,  134,  147,  132,  165,  187,
+       94,  100,   85,   67,   56,   53,   82,   84,
+       32,   24,   13,    5,   -2,    4,   17,   17,
+       13,    9,   -3,   -7,   -7,   -8,    3,   -1,
+        4,    7,   -6,    1,    0,   -5,   -1,   -8,
+       13,    8,    8,   10,   13,    0,    2,   -7,
+        0,    0,    0,    0,    0,    0,    0,    0},
+}};
+
+const Evaluation::ValueTables Evaluation::MIDDLEGAME_VALUES =
+    initValues(MIDDLEGAME_MATERIAL, MIDDLEGAME_SQUARES);
+const Evaluation::ValueTables Evaluation::ENDGAME_VALUES =
+    initValues(ENDGAME_MATERIAL, ENDGAME_SQUARES);
+const std::array<Bitboard, Evaluation::NUMBER_ROWS> Evaluation::FILE_MASKS =
+    initFileMasks();
+const Evaluation::PawnMasks Evaluation::PASSED_MASKS =
+    initPawnMasks(true, true);
+const Evaluation::PawnMasks Evaluation::SUPPORT_MASKS =
+    initPawnMasks(false, false);
+
+Evaluation::ValueTables Evaluation::initValues(
+    const std::array<int, NUMBER_FIGURE_TYPES> &material,
+    const SquareTables &squares) {
+    constexpr int rowMirror{BoardUtils::NUMBER_SQUARES -
+                            BoardUtils::NUMBER_SQUARE_PER_ROW};
+    ValueTables values{};
+    for (int figureType{}; figureType < NUMBER_FIGURE_TYPES; figureType++)
+        for (int coordinate{}; coordinate < BoardUtils::NUMBER_SQUARES;
+             coordinate++) {
+            const auto type{static_cast<FigureType>(figureType)};
+            values[getTableIndex(type, Color::ColorT::WHITE)][coordinate] =
+                material[figureType] + squares[figureType][coordinate];
+            values[getTableIndex(type, Color::ColorT::BLACK)][coordinate] =
+                -(material[figureType] +
+                  squares[figureType][coordinate ^ rowMirror]);
+        }
+    return values;
+}
+
+std::array<Bitboard, Evaluation::NUMBER_ROWS> Evaluation::initFileMasks() {
+    std::array<Bitboard, NUMBER_ROWS> fileMasks{};
+    for (int coordinate{}; coordinate < BoardUtils::NUMBER_SQUARES;
+         coordinate++)
+        fileMasks[coordinate % NUMBER_ROWS] |=
+            BitboardUtils::squareBit(coordinate);
+    return fileMasks;
+}
+
+Evaluation::PawnMasks Evaluation::initPawnMasks(bool ahead, bool sameFile) {
+    PawnMasks masks{};
+    for (const Color::ColorT color :
+         {Color::ColorT::BLACK, Color::ColorT::WHITE})
+        for (int coordinate{}; coordinate < BoardUtils::NUMBER_SQUARES;
+             coordinate++)
+            for (int other{}; other < BoardUtils::NUMBER_SQUARES; other++) {
+                const int rowSteps{
+                    (other / NUMBER_ROWS - coordinate / NUMBER_ROWS) *
+                    Color::getDirection(color)};
+                const int fileDistance{
+                    std::abs(other % NUMBER_ROWS - coordinate % NUMBER_ROWS)};
+                if ((ahead ? rowSteps > 0 : rowSteps <= 0) &&
+                    fileDistance <= 1 && (sameFile || fileDistance))
+                    masks[static_cast<int>(color)][coordinate] |=
+                        BitboardUtils::squareBit(other);
+            }
+    return masks;
+}
+
+void Evaluation::addPawnTerms(const Position &position, Color::ColorT color,
+                              int &middlegameScore, int &endgameScore) {
+    const int colorIndex{static_cast<int>(color)};
+    const Bitboard pawns{position.getFigures(FigureType::PAWN, color)};
+    const Bitboard enemyPawns{position.getFigures(
+        FigureType::PAWN, Color::getOppositeColor(color))};
+    for (Bitboard remaining{pawns}; remaining;) {
+        const int coordinate{BitboardUtils::popLsb(remaining)};
+        const int file{coordinate % NUMBER_ROWS};
+        if (!(PASSED_MASKS[colorIndex][coordinate] & enemyPawns)) {
+            const int row{coordinate / NUMBER_ROWS};
+            const int rank{color == Color::ColorT::WHITE ? NUMBER_ROWS - 1 - row
+                                                         : row};
+            middlegameScore += PASSED_MIDDLEGAME[rank];
+            endgameScore += PASSED_ENDGAME[rank];
+        }
+        const Bitboard neighbourFiles{
+            (file > 0 ? FILE_MASKS[file - 1] : 0) |
+            (file < NUMBER_ROWS - 1 ? FILE_MASKS[file + 1] : 0)};
+        if (!(pawns & neighbourFiles)) {
+            middlegameScore += ISOLATED_MIDDLEGAME;
+            endgameScore += ISOLATED_ENDGAME;
+        } else if (!(pawns & SUPPORT_MASKS[colorIndex][coordinate]) &&
+                   (BitboardUtils::getPawnAttacks(
+                        color, coordinate + Color::getDirection(color) *
+                                                NUMBER_ROWS) &
+                    enemyPawns)) {
+            middlegameScore += BACKWARD_MIDDLEGAME;
+            endgameScore += BACKWARD_ENDGAME;
+        }
+    }
+    for (const Bitboard fileMask : FILE_MASKS)
+        if (const int count{BitboardUtils::popCount(pawns & fileMask)};
+            count > 1) {
+            middlegameScore += DOUBLED_MIDDLEGAME * (count - 1);
+            endgameScore += DOUBLED_ENDGAME * (count - 1);
+        }
+}
+
+int Evaluation::getShelter(const Position &position, Color::ColorT color,
+                           int kingCoordinate) {
+    const Bitboard pawns{position.getFigures(FigureType::PAWN, color)};
+    const int kingRow{kingCoordinate / NUMBER_ROWS};
+    const int kingFile{kingCoordinate % NUMBER_ROWS};
+    const auto isPawnOn{[&](int row, int file) {
+        return row >= 0 && row < NUMBER_ROWS &&
+               BitboardUtils::isSet(pawns, row * NUMBER_ROWS + file);
+    }};
+    int shelter{};
+    for (int file{std::max(kingFile - 1, 0)};
+         file <= std::min(kingFile + 1, NUMBER_ROWS - 1); file++) {
+        if (isPawnOn(kingRow + Color::getDirection(color), file))
+            continue;
+        shelter += isPawnOn(kingRow + 2 * Color::getDirection(color), file)
+                       ? SHELTER_SECOND_ROW
+                       : SHELTER_MISSING;
+    }
+    return shelter;
+}
+
+void Evaluation::addMaterialTerms(const Position &position,
+                                  Color::ColorT color, int &middlegameScore,
+                                  int &endgameScore) {
+    const auto count{[&](FigureType figureType) {
+        return BitboardUtils::popCount(position.getFigures(figureType, color));
+    }};
+    if (count(FigureType::BISHOP) >= 2) {
+        middlegameScore += BISHOP_PAIR_MIDDLEGAME;
+        endgameScore += BISHOP_PAIR_ENDGAME;
+    }
+    const int pawnAdjustment{
+        (count(FigureType::KNIGHT) * KNIGHT_PAWN_BONUS +
+         count(FigureType::ROOK) * ROOK_PAWN_BONUS) *
+        (count(FigureType::PAWN) - BASE_PAWNS)};
+    middlegameScore += pawnAdjustment;
+    endgameScore += pawnAdjustment;
+}
+
+void Evaluation::fillPawnEntry(const Position &position, PawnEntry &entry) {
+    int whiteMiddlegame{}, whiteEndgame{}, blackMiddlegame{}, blackEndgame{};
+    addPawnTerms(position, Color::ColorT::WHITE, whiteMiddlegame,
+                 whiteEndgame);
+    addPawnTerms(position, Color::ColorT::BLACK, blackMiddlegame,
+                 blackEndgame);
+    entry = {position.getPawnKey(),
+             static_cast<std::int16_t>(whiteMiddlegame - blackMiddlegame),
+             static_cast<std::int16_t>(whiteEndgame - blackEndgame)};
+}
+
+void Evaluation::fillMaterialEntry(const Position &position,
+                                   MaterialEntry &entry) {
+    int whiteMiddlegame{}, whiteEndgame{}, blackMiddlegame{}, blackEndgame{};
+    addMaterialTerms(position, Color::ColorT::WHITE, whiteMiddlegame,
+                     whiteEndgame);
+    addMaterialTerms(position, Color::ColorT::BLACK, blackMiddlegame,
+                     blackEndgame);
+    entry = {position.getMaterialKey(),
+             static_cast<std::int16_t>(whiteMiddlegame - blackMiddlegame),
+             static_cast<std::int16_t>(whiteEndgame - blackEndgame)};
+}
+
+/*
+    The piece-square sums come from the position, the rest from the tables.
+    A pawn entry keeps the shelter of each king until the king stands on
+    another square. A promotion can take the phase above the one of the
+    starting position, it is then played as a middlegame.
+*/
+int Evaluation::getScore(const Position &position, PawnTable &pawnTable,
+                         MaterialTable &materialTable) {
+    int middlegameScore{position.getMiddlegameScore()};
+    int endgameScore{position.getEndgameScore()};
+    bool found{};
+    MaterialEntry &materialEntry{
+        materialTable.probe(position.getMaterialKey(), found)};
+    if (!found)
+        fillMaterialEntry(position, materialEntry);
+    middlegameScore += materialEntry.middlegameScore;
+    endgameScore += materialEntry.endgameScore;
+    PawnEntry &pawnEntry{pawnTable.probe(position.getPawnKey(), found)};
+    if (!found)
+        fillPawnEntry(position, pawnEntry);
+    middlegameScore += pawnEntry.middlegameScore;
+    endgameScore += pawnEntry.endgameScore;
+    for (const Color::ColorT color :
+         {Color::ColorT::WHITE, Color::ColorT::BLACK}) {
+        const int colorIndex{static_cast<int>(color)};
+        const int kingCoordinate{position.getKingCoordinate(color)};
+        if (pawnEntry.shelterCoordinates[colorIndex] != kingCoordinate) {
+            pawnEntry.shelterCoordinates[colorIndex] =
+                static_cast<std::int8_t>(kingCoordinate);
+            pawnEntry.shelterScores[colorIndex] = static_cast<std::int16_t>(
+                getShelter(position, color, kingCoordinate));
+        }
+        middlegameScore += color == Color::ColorT::WHITE
+                               ? pawnEntry.shelterScores[colorIndex]
+                               : -pawnEntry.shelterScores[colorIndex];
+    }
+    const int phase{std::min(position.getPhase(), MAX_PHASE)};
+    return (middlegameScore * phase + endgameScore * (MAX_PHASE - phase)) /
+           MAX_PHASE;
+}
+
+int Evaluation::evaluate(const Position &position, PawnTable &pawnTable,
+                         MaterialTable &materialTable) {
+    const int score{getScore(position, pawnTable, materialTable)};
+    return position.getSideToMove() == Color::ColorT::WHITE ? score : -score;
+}
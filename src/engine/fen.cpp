@@ -0,0 +1,262 @@
+#include "fen.h"
+#include "bitboard.h"
+#include <charconv>
+#include <stdexcept>
+
+std::string_view Fen::nextField(std::string_view &record) {
+    constexpr std::string_view SEPARATORS{" \t\r\n"};
+    const std::size_t start{
+        std::min(record.find_first_not_of(SEPARATORS), record.size())};
+    const std::size_t end{
+        std::min(record.find_first_of(SEPARATORS, start), record.size())};
+    const std::string_view field{record.substr(start, end - start)};
+    record.remove_prefix(end);
+    return field;
+}
+
+bool Fen::parseNumber(std::string_view field, int &number) {
+    int parsed{};
+    const auto [end, error]{
+        std::from_chars(field.data(), field.data() + field.size(), parsed)};
+    if (error != std::errc{} || end != field.data() + field.size() ||
+        parsed < 0)
+        return false;
+    number = parsed;
+    return true;
+}
+
+bool Fen::parsePosition(std::string_view &record, Position &position) {
+    position = Position{};
+    const std::string_view placement{nextField(record)};
+    const std::string_view side{nextField(record)};
+    const std::string_view castling{nextField(record)};
+    const std::string_view enPassant{nextField(record)};
+    if (!parsePlacement(placement, position) || !isValid(position) ||
+        (side != "w" && side != "b"))
+        return false;
+    const Color::ColorT sideToMove{side == "w" ? Color::ColorT::WHITE
+                                               : Color::ColorT::BLACK};
+    position.setSideToMove(sideToMove);
+    // the king of the side that just moved cannot be left in check
+    return !position.isInCheck(Color::getOppositeColor(sideToMove)) &&
+           parseCastlingRights(castling, position) &&
+           parseEnPassant(enPassant, position);
+}
+
+/*
+    Ranks from the eighth to the first, each one filled by figure symbols and
+    counts of empty squares up to exactly eight squares.
+*/
+bool Fen::parsePlacement(std::string_view placement, Position &position) {
+    int coordinate{};
+    int rowEnd{BoardUtils::NUMBER_SQUARE_PER_ROW};
+    for (const char symbol : placement) {
+        if (symbol == '/') {
+            if (coordinate != rowEnd || rowEnd == BoardUtils::NUMBER_SQUARES)
+                return false;
+            rowEnd += BoardUtils::NUMBER_SQUARE_PER_ROW;
+        } else if (symbol >= '1' && symbol <= '8') {
+            coordinate += symbol - '0';
+        } else {
+            const bool isWhite{symbol < 'a'};
+            const std::size_t figureType{FIGURE_SYMBOLS.find(
+                isWhite ? symbol : static_cast<char>(symbol - 'a' + 'A'))};
+            if (figureType == std::string_view::npos || coordinate >= rowEnd)
+                return false;
+            position.addFigure(static_cast<FigureType>(figureType),
+                               isWhite ? Color::ColorT::WHITE
+                                       : Color::ColorT::BLACK,
+                               coordinate++);
+        }
+        if (coordinate > rowEnd)
+            return false;
+    }
+    return coordinate == BoardUtils::NUMBER_SQUARES &&
+           rowEnd == BoardUtils::NUMBER_SQUARES;
+}
+
+bool Fen::parseCastlingRights(std::string_view castling, Position &position) {
+    if (castling.empty() || castling == "-")
+        return true;
+    int castlingRights{};
+    for (const char symbol : castling) {
+        const std::size_t right{CASTLING_SYMBOLS.find(symbol)};
+        if (right == std::string_view::npos)
+            return false;
+        castlingRights |= 1 << right;
+    }
+    auto hasFigure{[&position](FigureType figureType, Color::ColorT color,
+                               int coordinate) {
+        return position.isOccupied(coordinate) &&
+               position.getFigureType(coordinate) == figureType &&
+               position.getColor(coordinate) == color;
+    }};
+    auto hasRight{[&hasFigure](int kingCoordinate, int rookCoordinate,
+                               Color::ColorT color) {
+        return hasFigure(FigureType::KING, color, kingCoordinate) &&
+               hasFigure(FigureType::ROOK, color, rookCoordinate);
+    }};
+    using enum Color::ColorT;
+    position.setCastlingRights(
+        castlingRights &
+        ((hasRight(60, 63, WHITE) ? Position::WHITE_KING_SIDE : 0) |
+         (hasRight(60, 56, WHITE) ? Position::WHITE_QUEEN_SIDE : 0) |
+         (hasRight(4, 7, BLACK) ? Position::BLACK_KING_SIDE : 0) |
+         (hasRight(4, 0, BLACK) ? Position::BLACK_QUEEN_SIDE : 0)));
+    return true;
+}
+
+bool Fen::parseEnPassant(std::string_view enPassant, Position &position) {
+    if (enPassant.empty() || enPassant == "-")
+        return true;
+    const int coordinate{BoardUtils::parseCoordinate(enPassant)};
+    if (coordinate < 0)
+        return false;
+    const Color::ColorT pawnColor{
+        Color::getOppositeColor(position.getSideToMove())};
+    const bool isPassedRank{pawnColor == Color::ColorT::WHITE
+                                ? BoardUtils::THIRD_RANK[coordinate]
+                                : BoardUtils::SIXTH_RANK[coordinate]};
+    const int pawnCoordinate{
+        coordinate +
+        Color::getDirection(pawnColor) * BoardUtils::NUMBER_SQUARE_PER_ROW};
+    if (isPassedRank && !position.isOccupied(coordinate) &&
+        position.isOccupied(pawnCoordinate) &&
+        position.getFigureType(pawnCoordinate) == FigureType::PAWN &&
+        position.getColor(pawnCoordinate) == pawnColor)
+        position.setEnPassantCoordinate(coordinate);
+    return true;
+}
+
+bool Fen::isValid(const Position &position) {
+    constexpr Bitboard PROMOTION_RANKS{0xFF000000000000FF};
+    return BitboardUtils::popCount(
+               position.getFigures(FigureType::KING, Color::ColorT::WHITE)) ==
+               1 &&
+           BitboardUtils::popCount(
+               position.getFigures(FigureType::KING, Color::ColorT::BLACK)) ==
+               1 &&
+           !(position.getFigures(FigureType::PAWN) & PROMOTION_RANKS);
+}
+
+char Fen::getFigureSymbol(FigureType figureType, Color::ColorT color) {
+    const char symbol{FIGURE_SYMBOLS[static_cast<int>(figureType)]};
+    return color == Color::ColorT::WHITE ? symbol
+                                         : static_cast<char>(symbol - 'A' +
+                                                             'a');
+}
+
+void Fen::parse(std::string_view fen, Position &position) {
+    std::string_view record{fen};
+    int halfmoveClock{};
+    int fullmoveNumber{1};
+    const bool isValidPosition{parsePosition(record, position)};
+    const std::string_view halfmoveField{nextField(record)};
+    const std::string_view fullmoveField{nextField(record)};
+    if (!isValidPosition ||
+        (!halfmoveField.empty() &&
+         !parseNumber(halfmoveField, halfmoveClock)) ||
+        (!fullmoveField.empty() &&
+         !parseNumber(fullmoveField, fullmoveNumber)) ||
+        !nextField(record).empty())
+        throw std::invalid_argument("Invalid FEN: " + std::string(fen));
+    position.setHalfmoveClock(halfmoveClock);
+    position.setFullmoveNumber(fullmoveNumber);
+}
+
+std::string_view Fen::parseEpd(std::string_view epd, Position &position) {
+    std::string_view operations{epd};
+    if (!parsePosition(operations, position))
+        throw std::invalid_argument("Invalid EPD: " + std::string(epd));
+    int halfmoveClock{};
+    int fullmoveNumber{1};
+    // perft suites write the clocks of a FEN before the operations
+    std::string_view clocks{operations};
+    if (parseNumber(nextField(clocks), halfmoveClock) &&
+        parseNumber(nextField(clocks), fullmoveNumber)) {
+        operations = clocks;
+    } else {
+        const std::string_view halfmoveOperand{
+            getOperation(operations, "hmvc")};
+        const std::string_view fullmoveOperand{
+            getOperation(operations, "fmvn")};
+        halfmoveClock = 0;
+        fullmoveNumber = 1;
+        if ((!halfmoveOperand.empty() &&
+             !parseNumber(halfmoveOperand, halfmoveClock)) ||
+            (!fullmoveOperand.empty() &&
+             !parseNumber(fullmoveOperand, fullmoveNumber)))
+            throw std::invalid_argument("Invalid EPD: " + std::string(epd));
+    }
+    position.setHalfmoveClock(halfmoveClock);
+    position.setFullmoveNumber(fullmoveNumber);
+    return operations;
+}
+
+/*
+    Operations are separated by semicolons, a semicolon inside a quoted
+    operand does not end the operation.
+*/
+std::string_view Fen::getOperation(std::string_view operations,
+                                   std::string_view opcode) {
+    while (!operations.empty()) {
+        std::size_t end{};
+        for (bool isQuoted{}; end < operations.size(); end++) {
+            if (operations[end] == '"')
+                isQuoted = !isQuoted;
+            else if (operations[end] == ';' && !isQuoted)
+                break;
+        }
+        std::string_view operation{operations.substr(0, end)};
+        operations.remove_prefix(std::min(end + 1, operations.size()));
+        if (nextField(operation) != opcode)
+            continue;
+        const std::size_t first{operation.find_first_not_of(" \t")};
+        if (first == std::string_view::npos)
+            return {};
+        operation = operation.substr(
+            first, operation.find_last_not_of(" \t\r\n") - first + 1);
+        if (operation.size() >= 2 && operation.front() == '"' &&
+            operation.back() == '"')
+            operation = operation.substr(1, operation.size() - 2);
+        return operation;
+    }
+    return {};
+}
+
+std::string Fen::write(const Position &position) {
+    std::string fen;
+    fen.reserve(96);
+    for (int coordinate{}; coordinate < BoardUtils::NUMBER_SQUARES;) {
+        int emptySquares{};
+        do {
+            if (!position.isOccupied(coordinate)) {
+                emptySquares++;
+                continue;
+            }
+            if (emptySquares)
+                fen += static_cast<char>('0' + emptySquares);
+            emptySquares = 0;
+            fen += getFigureSymbol(position.getFigureType(coordinate),
+                                   position.getColor(coordinate));
+        } while (++coordinate % BoardUtils::NUMBER_SQUARE_PER_ROW);
+        if (emptySquares)
+            fen += static_cast<char>('0' + emptySquares);
+        if (coordinate < BoardUtils::NUMBER_SQUARES)
+            fen += '/';
+    }
+    fen += position.getSideToMove() == Color::ColorT::WHITE ? " w " : " b ";
+    for (std::size_t right{}; right < CASTLING_SYMBOLS.size(); right++)
+        if (position.getCastlingRights() & (1 << right))
+            fen += CASTLING_SYMBOLS[right];
+    if (!position.getCastlingRights())
+        fen += '-';
+    fen += ' ';
+    fen += position.getEnPassantCoordinate() < 0
+               ? "-"
+               : BoardUtils::getPositionAtCoordinate(
+                     position.getEnPassantCoordinate());
+    fen += ' ' + std::to_string(position.getHalfmoveClock()) + ' ' +
+           std::to_string(position.getFullmoveNumber());
+    return fen;
+}
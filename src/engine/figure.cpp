@@ -27,17 +27,43 @@ int Figure::getValue() const {
 }
 
 void Figure::move(int coordinate, Board &board) {
-    board.getSquare(coordinate)
-        ->setFigureOnSquare(board.getSquare(this->coordinate)->releaseFigure());
+    board.moveFigure(this->coordinate, coordinate);
     this->coordinate = coordinate;
     if (firstMove)
         firstMove = false;
 }
 
+void Figure::undoMove(int coordinate, Board &board, bool firstMove) {
+    board.moveFigure(this->coordinate, coordinate);
+    this->coordinate = coordinate;
+    setFirstMove(firstMove);
+}
+
 bool Figure::isFirstMove() const {
     return firstMove;
 }
 
+void Figure::setFirstMove(bool firstMove) {
+    this->firstMove = firstMove;
+}
+
+void Figure::calculateSlidingMoves(Board &board, Bitboard attacks,
+                                   Arena &arena, MoveVector &legalMoves) const {
+    const Position &position{board.getPosition()};
+    attacks &= ~position.getFigures(color);
+    while (attacks) {
+        const int candidateDestinationCoordinate{
+            BitboardUtils::popLsb(attacks)};
+        if (!position.isOccupied(candidateDestinationCoordinate))
+            legalMoves.push_back(arena.make<MajorMove>(
+                this, candidateDestinationCoordinate));
+        else
+            legalMoves.push_back(arena.make<MajorAttackMove>(
+                this, board.getSquare(candidateDestinationCoordinate)
+                          ->getFigureOnSquare()));
+    }
+}
+
 bool Figure::equals(const Figure &other) const {
     return this == &other ||
            (typeid(*this) == typeid(other) && coordinate == other.coordinate &&
@@ -58,12 +84,13 @@ bool King::isEightColumnExclusion(int currentPosition, int candidateOffset) {
 }
 
 King::King(int coordinate, Color::ColorT color)
-    : Figure(coordinate, color, FigureType::KING, 90) {
+    : Figure(coordinate, color, FigureType::KING,
+             Position::getFigureValue(FigureType::KING)) {
 }
 
-std::vector<std::unique_ptr<Move>>
-King::calculateLegalMoves(Board &board) const {
-    std::vector<std::unique_ptr<Move>> legalMoves;
+void King::calculateLegalMoves(Board &board, Arena &arena,
+                               MoveVector &legalMoves) const {
+    const Position &position{board.getPosition()};
     for (auto &currentCandidateOffset : CANDIDATE_MOVE_COORDINATES) {
         if (isFirstColumnExclusion(coordinate, currentCandidateOffset) ||
             isEightColumnExclusion(coordinate, currentCandidateOffset)) {
@@ -73,24 +100,19 @@ King::calculateLegalMoves(Board &board) const {
                                                  currentCandidateOffset};
         if (BoardUtils::isValidSquareCoordinate(
                 candidateDestinationCoordinate)) {
-            Square *candidateDestinationSquare =
-                board.getSquare(candidateDestinationCoordinate);
-            if (!candidateDestinationSquare->isSquareOccupied()) {
-                legalMoves.push_back(std::make_unique<MajorMove>(
+            if (!position.isOccupied(candidateDestinationCoordinate)) {
+                legalMoves.push_back(arena.make<MajorMove>(
                     this, candidateDestinationCoordinate));
-            } else {
+            } else if (position.getColor(candidateDestinationCoordinate) !=
+                       color) {
                 Figure *figureAtDestination{
-                    candidateDestinationSquare->getFigureOnSquare()};
-                const Color::ColorT figureColor{
-                    figureAtDestination->getColor()};
-                if (this->color != figureColor) {
-                    legalMoves.push_back(std::make_unique<MajorAttackMove>(
-                        this, figureAtDestination));
-                }
+                    board.getSquare(candidateDestinationCoordinate)
+                        ->getFigureOnSquare()};
+                legalMoves.push_back(arena.make<MajorAttackMove>(
+                    this, figureAtDestination));
             }
         }
     }
-    return legalMoves;
 }
 
 bool King::isCastled() const {
@@ -121,56 +143,16 @@ bool King::equals(const Figure &other) const {
 }
 
 Queen::Queen(int coordinate, Color::ColorT color)
-    : Figure(coordinate, color, FigureType::QUEEN, 9) {
-}
-
-bool Queen::isFirstColumnExclusion(int currentPosition, int candidateOffset) {
-    return BoardUtils::FIRST_COLUMN[currentPosition] &&
-           (candidateOffset == -9 || candidateOffset == -1 ||
-            candidateOffset == 7);
+    : Figure(coordinate, color, FigureType::QUEEN,
+             Position::getFigureValue(FigureType::QUEEN)) {
 }
 
-bool Queen::isEightColumnExclusion(int currentPosition, int candidateOffset) {
-    return BoardUtils::EIGHT_COLUMN[currentPosition] &&
-           (candidateOffset == -7 || candidateOffset == 1 ||
-            candidateOffset == 9);
-}
-
-std::vector<std::unique_ptr<Move>>
-Queen::calculateLegalMoves(Board &board) const {
-    std::vector<std::unique_ptr<Move>> legalMoves;
-    for (int currentCandidateOffset : CANDIDATE_MOVE_VECTOR_COORDINATES) {
-        int candidateDestinationCoordinate{coordinate};
-        while (BoardUtils::isValidSquareCoordinate(
-            candidateDestinationCoordinate)) {
-            if (isFirstColumnExclusion(candidateDestinationCoordinate,
-                                       currentCandidateOffset) ||
-                isEightColumnExclusion(candidateDestinationCoordinate,
-                                       currentCandidateOffset)) {
-                break;
-            }
-            candidateDestinationCoordinate += currentCandidateOffset;
-            if (BoardUtils::isValidSquareCoordinate(
-                    candidateDestinationCoordinate)) {
-                Square *candidateDestinationSquare =
-                    board.getSquare(candidateDestinationCoordinate);
-                if (!candidateDestinationSquare->isSquareOccupied()) {
-                    legalMoves.push_back(std::make_unique<MajorMove>(
-                        this, candidateDestinationCoordinate));
-                } else {
-                    Figure *figureAtDestination{
-                        candidateDestinationSquare->getFigureOnSquare()};
-                    Color::ColorT figureColor{figureAtDestination->getColor()};
-                    if (color != figureColor) {
-                        legalMoves.push_back(std::make_unique<MajorAttackMove>(
-                            this, figureAtDestination));
-                    }
-                    break;
-                }
-            }
-        }
-    }
-    return legalMoves;
+void Queen::calculateLegalMoves(Board &board, Arena &arena,
+                                MoveVector &legalMoves) const {
+    calculateSlidingMoves(board,
+                          BitboardUtils::getQueenAttacks(
+                              coordinate, board.getPosition().getOccupancy()),
+                          arena, legalMoves);
 }
 
 std::string Queen::getFigureName() const {
@@ -182,52 +164,16 @@ std::unique_ptr<Figure> Queen::clone() const {
 }
 
 Rook::Rook(int coordinate, Color::ColorT color)
-    : Figure(coordinate, color, FigureType::ROOK, 5) {
-}
-
-bool Rook::isFirstColumnExclusion(int currentPosition, int candidateOffset) {
-    return BoardUtils::FIRST_COLUMN[currentPosition] && (candidateOffset == -1);
+    : Figure(coordinate, color, FigureType::ROOK,
+             Position::getFigureValue(FigureType::ROOK)) {
 }
 
-bool Rook::isEightColumnExclusion(int currentPosition, int candidateOffset) {
-    return BoardUtils::EIGHT_COLUMN[currentPosition] && (candidateOffset == 1);
-}
-
-std::vector<std::unique_ptr<Move>>
-Rook::calculateLegalMoves(Board &board) const {
-    std::vector<std::unique_ptr<Move>> legalMoves;
-    for (int currentCandidateOffset : CANDIDATE_MOVE_VECTOR_COORDINATES) {
-        int candidateDestinationCoordinate{coordinate};
-        while (BoardUtils::isValidSquareCoordinate(
-            candidateDestinationCoordinate)) {
-            if (isFirstColumnExclusion(candidateDestinationCoordinate,
-                                       currentCandidateOffset) ||
-                isEightColumnExclusion(candidateDestinationCoordinate,
-                                       currentCandidateOffset)) {
-                break;
-            }
-            candidateDestinationCoordinate += currentCandidateOffset;
-            if (BoardUtils::isValidSquareCoordinate(
-                    candidateDestinationCoordinate)) {
-                Square *candidateDestinationSquare =
-                    board.getSquare(candidateDestinationCoordinate);
-                if (!candidateDestinationSquare->isSquareOccupied()) {
-                    legalMoves.push_back(std::make_unique<MajorMove>(
-                        this, candidateDestinationCoordinate));
-                } else {
-                    Figure *figureAtDestination{
-                        candidateDestinationSquare->getFigureOnSquare()};
-                    Color::ColorT figureColor{figureAtDestination->getColor()};
-                    if (color != figureColor) {
-                        legalMoves.push_back(std::make_unique<MajorAttackMove>(
-                            this, figureAtDestination));
-                    }
-                    break;
-                }
-            }
-        }
-    }
-    return legalMoves;
+void Rook::calculateLegalMoves(Board &board, Arena &arena,
+                               MoveVector &legalMoves) const {
+    calculateSlidingMoves(board,
+                          BitboardUtils::getRookAttacks(
+                              coordinate, board.getPosition().getOccupancy()),
+                          arena, legalMoves);
 }
 
 std::string Rook::getFigureName() const {
@@ -239,7 +185,8 @@ std::unique_ptr<Figure> Rook::clone() const {
 }
 
 Knight::Knight(int coordinate, Color::ColorT color)
-    : Figure(coordinate, color, FigureType::KNIGHT, 3) {
+    : Figure(coordinate, color, FigureType::KNIGHT,
+             Position::getFigureValue(FigureType::KNIGHT)) {
 }
 
 bool Knight::isFirstColumnExclusion(int currentPosition, int candidateOffset) {
@@ -265,9 +212,9 @@ bool Knight::isEightColumnExclusion(int currentPosition, int candidateOffset) {
             (candidateOffset == 10) || (candidateOffset == 17));
 }
 
-std::vector<std::unique_ptr<Move>>
-Knight::calculateLegalMoves(Board &board) const {
-    std::vector<std::unique_ptr<Move>> legalMoves;
+void Knight::calculateLegalMoves(Board &board, Arena &arena,
+                                 MoveVector &legalMoves) const {
+    const Position &position{board.getPosition()};
     for (auto &currentCandidateOffset : CANDIDATE_MOVE_COORDINATES) {
         if (isFirstColumnExclusion(coordinate, currentCandidateOffset) ||
             isSecondColumnExclusion(coordinate, currentCandidateOffset) ||
@@ -279,23 +226,19 @@ Knight::calculateLegalMoves(Board &board) const {
                                                  currentCandidateOffset};
         if (BoardUtils::isValidSquareCoordinate(
                 candidateDestinationCoordinate)) {
-            Square *candidateDestinationSquare{
-                board.getSquare(candidateDestinationCoordinate)};
-            if (!candidateDestinationSquare->isSquareOccupied()) {
-                legalMoves.push_back(std::make_unique<MajorMove>(
+            if (!position.isOccupied(candidateDestinationCoordinate)) {
+                legalMoves.push_back(arena.make<MajorMove>(
                     this, candidateDestinationCoordinate));
-            } else {
+            } else if (position.getColor(candidateDestinationCoordinate) !=
+                       color) {
                 Figure *figureAtDestination{
-                    candidateDestinationSquare->getFigureOnSquare()};
-                Color::ColorT figureColor{figureAtDestination->getColor()};
-                if (color != figureColor) {
-                    legalMoves.push_back(std::make_unique<MajorAttackMove>(
-                        this, figureAtDestination));
-                }
+                    board.getSquare(candidateDestinationCoordinate)
+                        ->getFigureOnSquare()};
+                legalMoves.push_back(arena.make<MajorAttackMove>(
+                    this, figureAtDestination));
             }
         }
     }
-    return legalMoves;
 }
 
 std::string Knight::getFigureName() const {
@@ -307,54 +250,16 @@ std::unique_ptr<Figure> Knight::clone() const {
 }
 
 Bishop::Bishop(int coordinate, Color::ColorT color)
-    : Figure(coordinate, color, FigureType::BISHOP, 3) {
+    : Figure(coordinate, color, FigureType::BISHOP,
+             Position::getFigureValue(FigureType::BISHOP)) {
 }
 
-bool Bishop::isFirstColumnExclusion(int currentPosition, int candidateOffset) {
-    return BoardUtils::FIRST_COLUMN[currentPosition] &&
-           (candidateOffset == -9 || candidateOffset == 7);
-}
-
-bool Bishop::isEightColumnExclusion(int currentPosition, int candidateOffset) {
-    return BoardUtils::EIGHT_COLUMN[currentPosition] &&
-           (candidateOffset == -7 || candidateOffset == 9);
-}
-
-std::vector<std::unique_ptr<Move>>
-Bishop::calculateLegalMoves(Board &board) const {
-    std::vector<std::unique_ptr<Move>> legalMoves;
-    for (int currentCandidateOffset : CANDIDATE_MOVE_VECTOR_COORDINATES) {
-        int candidateDestinationCoordinate{coordinate};
-        while (BoardUtils::isValidSquareCoordinate(
-            candidateDestinationCoordinate)) {
-            if (isFirstColumnExclusion(candidateDestinationCoordinate,
-                                       currentCandidateOffset) ||
-                isEightColumnExclusion(candidateDestinationCoordinate,
-                                       currentCandidateOffset)) {
-                break;
-            }
-            candidateDestinationCoordinate += currentCandidateOffset;
-            if (BoardUtils::isValidSquareCoordinate(
-                    candidateDestinationCoordinate)) {
-                Square *candidateDestinationSquare =
-                    board.getSquare(candidateDestinationCoordinate);
-                if (!candidateDestinationSquare->isSquareOccupied()) {
-                    legalMoves.push_back(std::make_unique<MajorMove>(
-                        this, candidateDestinationCoordinate));
-                } else {
-                    Figure *figureAtDestination{
-                        candidateDestinationSquare->getFigureOnSquare()};
-                    Color::ColorT figureColor{figureAtDestination->getColor()};
-                    if (color != figureColor) {
-                        legalMoves.push_back(std::make_unique<MajorAttackMove>(
-                            this, figureAtDestination));
-                    }
-                    break;
-                }
-            }
-        }
-    }
-    return legalMoves;
+void Bishop::calculateLegalMoves(Board &board, Arena &arena,
+                                 MoveVector &legalMoves) const {
+    calculateSlidingMoves(board,
+                          BitboardUtils::getBishopAttacks(
+                              coordinate, board.getPosition().getOccupancy()),
+                          arena, legalMoves);
 }
 
 std::string Bishop::getFigureName() const {
@@ -366,7 +271,8 @@ std::unique_ptr<Figure> Bishop::clone() const {
 }
 
 Pawn::Pawn(int coordinate, Color::ColorT color)
-    : Figure(coordinate, color, FigureType::PAWN, 1) {
+    : Figure(coordinate, color, FigureType::PAWN,
+             Position::getFigureValue(FigureType::PAWN)) {
 }
 
 bool Pawn::isHasEnPassantMove(Board &board, int enPassantCoordinate) const {
@@ -383,9 +289,16 @@ bool Pawn::isHasEnPassantMove(Board &board, int enPassantCoordinate) const {
     return false;
 }
 
-std::vector<std::unique_ptr<Move>>
-Pawn::calculateLegalMoves(Board &board) const {
-    std::vector<std::unique_ptr<Move>> legalMoves;
+void Pawn::addPromotionMoves(Arena &arena, MoveVector &legalMoves,
+                             const Move &move) {
+    for (FigureType promotionType : PROMOTION_FIGURE_TYPES)
+        legalMoves.push_back(
+            arena.make<PawnPromotion>(move.clone(arena), promotionType));
+}
+
+void Pawn::calculateLegalMoves(Board &board, Arena &arena,
+                               MoveVector &legalMoves) const {
+    const Position &position{board.getPosition()};
     for (auto &currentCandidateOffset : CANDIDATE_MOVE_COORDINATES) {
         const int candidateDestinationCoordinate{
             coordinate + (currentCandidateOffset * Color::getDirection(color))};
@@ -394,15 +307,14 @@ Pawn::calculateLegalMoves(Board &board) const {
             continue;
         }
         if (currentCandidateOffset == 8 &&
-            !board.getSquare(candidateDestinationCoordinate)
-                 ->isSquareOccupied()) {
+            !position.isOccupied(candidateDestinationCoordinate)) {
             if (Color::isPawnPromotionSquare(color,
                                              candidateDestinationCoordinate)) {
-                legalMoves.push_back(
-                    std::make_unique<PawnPromotion>(std::make_unique<PawnMove>(
-                        this, candidateDestinationCoordinate)));
+                addPromotionMoves(
+                    arena, legalMoves,
+                    PawnMove(this, candidateDestinationCoordinate));
             } else {
-                legalMoves.push_back(std::make_unique<PawnMove>(
+                legalMoves.push_back(arena.make<PawnMove>(
                     this, candidateDestinationCoordinate));
             }
         } else if (currentCandidateOffset == 16 && isFirstMove() &&
@@ -412,11 +324,9 @@ Pawn::calculateLegalMoves(Board &board) const {
                      color == Color::ColorT::WHITE))) {
             const int behindCandidateDestinationCoordinate{
                 coordinate + (Color::getDirection(color) * 8)};
-            if (!board.getSquare(behindCandidateDestinationCoordinate)
-                     ->isSquareOccupied() &&
-                !board.getSquare(candidateDestinationCoordinate)
-                     ->isSquareOccupied()) {
-                legalMoves.push_back(std::make_unique<PawnJump>(
+            if (!position.isOccupied(behindCandidateDestinationCoordinate) &&
+                !position.isOccupied(candidateDestinationCoordinate)) {
+                legalMoves.push_back(arena.make<PawnJump>(
                     this, candidateDestinationCoordinate));
             }
         } else if (currentCandidateOffset == 7 &&
@@ -424,19 +334,18 @@ Pawn::calculateLegalMoves(Board &board) const {
                       color == Color::ColorT::WHITE) ||
                      (BoardUtils::FIRST_COLUMN[coordinate] &&
                       color == Color::ColorT::BLACK))) {
-            if (board.getSquare(candidateDestinationCoordinate)
-                    ->isSquareOccupied()) {
+            if (position.isOccupied(candidateDestinationCoordinate)) {
                 Figure *figureOnCandidate{
                     board.getSquare(candidateDestinationCoordinate)
                         ->getFigureOnSquare()};
                 if (color != figureOnCandidate->getColor()) {
                     if (Color::isPawnPromotionSquare(
                             color, candidateDestinationCoordinate)) {
-                        legalMoves.push_back(std::make_unique<PawnPromotion>(
-                            std::make_unique<PawnAttackMove>(
-                                this, figureOnCandidate)));
+                        addPromotionMoves(
+                            arena, legalMoves,
+                            PawnAttackMove(this, figureOnCandidate));
                     } else {
-                        legalMoves.push_back(std::make_unique<PawnAttackMove>(
+                        legalMoves.push_back(arena.make<PawnAttackMove>(
                             this, figureOnCandidate));
                     }
                 }
@@ -447,7 +356,7 @@ Pawn::calculateLegalMoves(Board &board) const {
                         .getSquare(coordinate +
                                    Color::getOppositeDirection(color))
                         ->getFigureOnSquare();
-                legalMoves.push_back(std::make_unique<PawnEnPassantAttackMove>(
+                legalMoves.push_back(arena.make<PawnEnPassantAttackMove>(
                     this, figureOnCandidate, candidateDestinationCoordinate));
             }
         } else if (currentCandidateOffset == 9 &&
@@ -455,19 +364,18 @@ Pawn::calculateLegalMoves(Board &board) const {
                       color == Color::ColorT::BLACK) ||
                      (BoardUtils::FIRST_COLUMN[coordinate] &&
                       color == Color::ColorT::WHITE))) {
-            if (board.getSquare(candidateDestinationCoordinate)
-                    ->isSquareOccupied()) {
+            if (position.isOccupied(candidateDestinationCoordinate)) {
                 Figure *figureOnCandidate =
                     board.getSquare(candidateDestinationCoordinate)
                         ->getFigureOnSquare();
                 if (color != figureOnCandidate->getColor())
                     if (Color::isPawnPromotionSquare(
                             color, candidateDestinationCoordinate)) {
-                        legalMoves.push_back(std::make_unique<PawnPromotion>(
-                            std::make_unique<PawnAttackMove>(
-                                this, figureOnCandidate)));
+                        addPromotionMoves(
+                            arena, legalMoves,
+                            PawnAttackMove(this, figureOnCandidate));
                     } else {
-                        legalMoves.push_back(std::make_unique<PawnAttackMove>(
+                        legalMoves.push_back(arena.make<PawnAttackMove>(
                             this, figureOnCandidate));
                     }
             } else if (isHasEnPassantMove(board,
@@ -477,12 +385,11 @@ Pawn::calculateLegalMoves(Board &board) const {
                         .getSquare(coordinate -
                                    Color::getOppositeDirection(color))
                         ->getFigureOnSquare();
-                legalMoves.push_back(std::make_unique<PawnEnPassantAttackMove>(
+                legalMoves.push_back(arena.make<PawnEnPassantAttackMove>(
                     this, figureOnCandidate, candidateDestinationCoordinate));
             }
         }
     }
-    return legalMoves;
 }
 
 std::string Pawn::getFigureName() const {
@@ -3,7 +3,12 @@
 #include "figure.h"
 
 Move::Move(const Figure *figure, int coordinateToMove)
-    : movedFigure(figure), coordinateToMove(coordinateToMove) {
+    : movedFigure(figure), coordinateFrom(figure->getCoordinate()),
+      coordinateToMove(coordinateToMove) {
+}
+
+int Move::getCoordinateFrom() const {
+    return coordinateFrom;
 }
 
 int Move::getCoordinateToMove() const {
@@ -14,28 +19,28 @@ const Figure *Move::getMovedFigure() const {
     return movedFigure;
 }
 
-std::unique_ptr<Board> Move::execute(Board &board) const {
-    std::unique_ptr<Board> movedBoard(std::make_unique<Board>(board));
-    movedBoard->getSquare(movedFigure->getCoordinate())
+void Move::make(Board &board, MoveUndo &undo) const {
+    Figure *figure{board.getSquare(coordinateFrom)->getFigureOnSquare()};
+    undo.firstMove = figure->isFirstMove();
+    figure->move(coordinateToMove, board);
+}
+
+void Move::unmake(Board &board, MoveUndo &undo) const {
+    board.getSquare(coordinateToMove)
         ->getFigureOnSquare()
-        ->move(coordinateToMove, *movedBoard);
-    if (movedBoard->getEnPassantPawn())
-        movedBoard->setEnPassantPawn(nullptr);
-    return movedBoard;
+        ->undoMove(coordinateFrom, board, undo.firstMove);
 }
 
-bool Move::equals(const Move &other) const {
-    return this == &other || (typeid(*this) == typeid(other) &&
-                              movedFigure->equals(*other.movedFigure) &&
-                              coordinateToMove == other.coordinateToMove);
+CompactMove Move::toCompactMove() const {
+    return {coordinateFrom, coordinateToMove};
 }
 
-std::unique_ptr<Board> MajorMove::execute(Board &board) const {
-    return Move::execute(board);
+bool Move::equals(const Move &other) const {
+    return this == &other || toCompactMove() == other.toCompactMove();
 }
 
-std::unique_ptr<Move> MajorMove::clone() const {
-    return std::make_unique<MajorMove>(*this);
+MovePtr MajorMove::clone(Arena &arena) const {
+    return arena.make<MajorMove>(*this);
 }
 
 AttackMove::AttackMove(const Figure *figure, const Figure *attackFigure)
@@ -50,52 +55,26 @@ AttackMove::AttackMove(const Figure *figure, const Figure *attackFigure,
 const Figure *AttackMove::getAttackFigure() const {
     return attackFigure;
 }
-std::unique_ptr<Board> AttackMove::execute(Board &board) const {
-    // std::unique_ptr<Board> movedBoard(std::make_unique<Board>(board));
-    // movedBoard->getSquare(attackFigure->getCoordinate())
-    //     ->releaseFigure()
-    //     .reset();
-    // movedBoard->getSquare(movedFigure->getCoordinate())
-    //     ->getFigureOnSquare()
-    //     ->move(coordinateToMove, *movedBoard);
-    // return movedBoard;
-    return Move::execute(board);
-}
-
-bool AttackMove::equals(const Move &other) const {
-    if (this == &other)
-        return true;
-    try {
-        auto &otherAttack{dynamic_cast<const AttackMove &>(other)};
-        return (Move::equals(other) &&
-                attackFigure->equals(*otherAttack.attackFigure));
-    } catch (std::bad_cast &e) {
-        return false;
-    }
-}
-
-std::unique_ptr<Board> MajorAttackMove::execute(Board &board) const {
-    return AttackMove::execute(board);
-}
-
-std::unique_ptr<Move> MajorAttackMove::clone() const {
-    return std::make_unique<MajorAttackMove>(*this);
+void AttackMove::make(Board &board, MoveUndo &undo) const {
+    undo.capturedFigure = board.removeFigure(attackFigure->getCoordinate());
+    Move::make(board, undo);
 }
 
-std::unique_ptr<Board> PawnAttackMove::execute(Board &board) const {
-    return AttackMove::execute(board);
+void AttackMove::unmake(Board &board, MoveUndo &undo) const {
+    Move::unmake(board, undo);
+    board.setFigureOnBoard(std::move(undo.capturedFigure));
 }
 
-std::unique_ptr<Move> PawnAttackMove::clone() const {
-    return std::make_unique<PawnAttackMove>(*this);
+MovePtr MajorAttackMove::clone(Arena &arena) const {
+    return arena.make<MajorAttackMove>(*this);
 }
 
-std::unique_ptr<Board> PawnMove::execute(Board &board) const {
-    return Move::execute(board);
+MovePtr PawnAttackMove::clone(Arena &arena) const {
+    return arena.make<PawnAttackMove>(*this);
 }
 
-std::unique_ptr<Move> PawnMove::clone() const {
-    return std::make_unique<PawnMove>(*this);
+MovePtr PawnMove::clone(Arena &arena) const {
+    return arena.make<PawnMove>(*this);
 }
 
 PawnEnPassantAttackMove::PawnEnPassantAttackMove(const Figure *pawn,
@@ -104,117 +83,90 @@ PawnEnPassantAttackMove::PawnEnPassantAttackMove(const Figure *pawn,
     : PawnAttackMove(pawn, enPassantPawn, coordinateToMove) {
 }
 
-std::unique_ptr<Board> PawnEnPassantAttackMove::execute(Board &board) const {
-    auto movedBoard(PawnAttackMove::execute(board));
-    movedBoard->getSquare(attackFigure->getCoordinate())->releaseFigure();
-    return movedBoard;
+MovePtr PawnEnPassantAttackMove::clone(Arena &arena) const {
+    return arena.make<PawnEnPassantAttackMove>(*this);
 }
 
-std::unique_ptr<Move> PawnEnPassantAttackMove::clone() const {
-    return std::make_unique<PawnEnPassantAttackMove>(*this);
+CompactMove PawnEnPassantAttackMove::toCompactMove() const {
+    return {coordinateFrom, coordinateToMove, CompactMove::Flag::EN_PASSANT};
 }
 
-std::unique_ptr<Board> PawnJump::execute(Board &board) const {
-    auto movedBoard(Move::execute(board));
-    movedBoard->setEnPassantPawn(dynamic_cast<Pawn *>(
-        movedBoard->getSquare(coordinateToMove)->getFigureOnSquare()));
-    return movedBoard;
+void PawnJump::make(Board &board, MoveUndo &undo) const {
+    Move::make(board, undo);
+    board.setEnPassantPawn(static_cast<Pawn *>(
+        board.getSquare(coordinateToMove)->getFigureOnSquare()));
 }
 
-std::unique_ptr<Move> PawnJump::clone() const {
-    return std::make_unique<PawnJump>(*this);
+MovePtr PawnJump::clone(Arena &arena) const {
+    return arena.make<PawnJump>(*this);
 }
 
-PawnPromotion::PawnPromotion(std::unique_ptr<Move> decoratedMove)
+PawnPromotion::PawnPromotion(MovePtr decoratedMove, FigureType promotionType)
     : Move(decoratedMove->getMovedFigure(),
            decoratedMove->getCoordinateToMove()),
-      decoratedMove(std::move(decoratedMove)),
-      promotionFigure(
-          std::make_unique<Queen>(coordinateToMove, movedFigure->getColor())) {
+      promotionType(promotionType), decoratedMove(std::move(decoratedMove)) {
+}
+
+FigureType PawnPromotion::getPromotionType() const {
+    return promotionType;
 }
 
-PawnPromotion::PawnPromotion(const PawnPromotion &pawnPromotion)
-    : Move(pawnPromotion),
-      promotionFigure(pawnPromotion.promotionFigure
-                          ? pawnPromotion.promotionFigure->clone()
-                          : nullptr),
-      decoratedMove(pawnPromotion.decoratedMove->clone()) {
+void PawnPromotion::setPromotionType(FigureType promotionType) {
+    this->promotionType = promotionType;
 }
 
-void PawnPromotion::setPromotionFigure(std::unique_ptr<Figure> figure) {
-    promotionFigure = std::move(figure);
+void PawnPromotion::make(Board &board, MoveUndo &undo) const {
+    decoratedMove->make(board, undo);
+    undo.promotedPawn = board.removeFigure(coordinateToMove);
+    board.setFigureOnBoard(Board::createFigure(
+        promotionType, movedFigure->getColor(), coordinateToMove));
 }
 
-std::unique_ptr<Board> PawnPromotion::execute(Board &board) const {
-    std::unique_ptr<Board> movedBoard(decoratedMove->execute(board));
-    movedBoard->getSquare(decoratedMove->getCoordinateToMove())
-        ->setFigureOnSquare(promotionFigure->clone());
-    return movedBoard;
+void PawnPromotion::unmake(Board &board, MoveUndo &undo) const {
+    board.removeFigure(coordinateToMove);
+    board.setFigureOnBoard(std::move(undo.promotedPawn));
+    decoratedMove->unmake(board, undo);
 }
 
-std::unique_ptr<Move> PawnPromotion::clone() const {
-    return std::make_unique<PawnPromotion>(*this);
+MovePtr PawnPromotion::clone(Arena &arena) const {
+    return arena.make<PawnPromotion>(decoratedMove->clone(arena),
+                                     promotionType);
 }
 
-bool PawnPromotion::equals(const Move &other) const {
-    if (this == &other)
-        return true;
-    try {
-        auto &otherPromotion = dynamic_cast<const PawnPromotion &>(other);
-        return (Move::equals(other) &&
-                otherPromotion.promotionFigure->equals(*promotionFigure) &&
-                otherPromotion.decoratedMove->equals(*decoratedMove));
-    } catch (std::bad_cast &e) {
-        return false;
-    }
+CompactMove PawnPromotion::toCompactMove() const {
+    return {coordinateFrom, coordinateToMove, CompactMove::Flag::PROMOTION,
+            promotionType};
 }
 
 CastleMove::CastleMove(const Figure *king, int kingDestCoord,
                        const Figure *rook, int rookDestCoord)
     : Move(king, kingDestCoord), rook(rook),
+      rookCoordinate(rook->getCoordinate()),
       rookDestinationCoordinate(rookDestCoord) {
 }
 
-std::unique_ptr<Board> CastleMove::execute(Board &board) const {
-    //    std::unique_ptr<Board> movedBoard(std::make_unique<Board>(board));
-    //    std::unique_ptr<Figure> movedRook(
-    //        movedBoard->getSquare(rook->getCoordinate())->releaseFigure());
-    //    movedBoard->getSquare(movedFigure->getCoordinate())
-    //        ->getFigureOnSquare()
-    //        ->move(coordinateToMove, *movedBoard);
-    //    movedRook->move(rookDestinationCoordinate, *movedBoard);
-    auto movedBoard(Move::execute(board));
-    movedBoard->getSquare(rook->getCoordinate())
-        ->getFigureOnSquare()
-        ->move(rookDestinationCoordinate, *movedBoard);
-    return movedBoard;
-}
-
-bool CastleMove::equals(const Move &other) const {
-    if (this == &other)
-        return true;
-    try {
-        auto &otherCastle = dynamic_cast<const CastleMove &>(other);
-        return (Move::equals(other) && rook->equals(*otherCastle.rook) &&
-                rookDestinationCoordinate ==
-                    otherCastle.rookDestinationCoordinate);
-    } catch (std::bad_cast &e) {
-        return false;
-    }
+void CastleMove::make(Board &board, MoveUndo &undo) const {
+    Move::make(board, undo);
+    Figure *movedRook{board.getSquare(rookCoordinate)->getFigureOnSquare()};
+    undo.rookFirstMove = movedRook->isFirstMove();
+    movedRook->move(rookDestinationCoordinate, board);
 }
 
-std::unique_ptr<Board> KingSideCastleMove::execute(Board &board) const {
-    return CastleMove::execute(board);
+void CastleMove::unmake(Board &board, MoveUndo &undo) const {
+    board.getSquare(rookDestinationCoordinate)
+        ->getFigureOnSquare()
+        ->undoMove(rookCoordinate, board, undo.rookFirstMove);
+    Move::unmake(board, undo);
 }
 
-std::unique_ptr<Move> KingSideCastleMove::clone() const {
-    return std::make_unique<KingSideCastleMove>(*this);
+CompactMove CastleMove::toCompactMove() const {
+    return {coordinateFrom, coordinateToMove, CompactMove::Flag::CASTLING};
 }
 
-std::unique_ptr<Board> QueenSideCastleMove::execute(Board &board) const {
-    return CastleMove::execute(board);
+MovePtr KingSideCastleMove::clone(Arena &arena) const {
+    return arena.make<KingSideCastleMove>(*this);
 }
 
-std::unique_ptr<Move> QueenSideCastleMove::clone() const {
-    return std::make_unique<QueenSideCastleMove>(*this);
+MovePtr QueenSideCastleMove::clone(Arena &arena) const {
+    return arena.make<QueenSideCastleMove>(*this);
 }
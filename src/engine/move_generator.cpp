@@ -0,0 +1,280 @@
+#include "move_generator.h"
+
+void MoveGenerator::addMoves(int coordinateFrom, Bitboard targets,
+                             MoveList &moveList) {
+    while (targets)
+        moveList.add({coordinateFrom, BitboardUtils::popLsb(targets)});
+}
+
+void MoveGenerator::addPawnCaptures(const Position &position,
+                                    MoveList &moveList) {
+    const Color::ColorT color{position.getSideToMove()};
+    const Bitboard opponentFigures{
+        position.getFigures(Color::getOppositeColor(color))};
+    const int direction{Color::getDirection(color) *
+                        BoardUtils::NUMBER_SQUARE_PER_ROW};
+    const int enPassantCoordinate{position.getEnPassantCoordinate()};
+    const auto &lastRank{color == Color::ColorT::WHITE
+                             ? BoardUtils::EIGHTH_RANK
+                             : BoardUtils::FIRST_RANK};
+    for (Bitboard pawns{position.getFigures(FigureType::PAWN, color)};
+         pawns;) {
+        const int coordinateFrom{BitboardUtils::popLsb(pawns)};
+        const Bitboard attacks{
+            BitboardUtils::getPawnAttacks(color, coordinateFrom)};
+        Bitboard targets{attacks & opponentFigures};
+        // the push to the last rank wins material like a capture
+        if (const int pushCoordinate{coordinateFrom + direction};
+            BoardUtils::isValidSquareCoordinate(pushCoordinate) &&
+            lastRank[pushCoordinate] && !position.isOccupied(pushCoordinate))
+            targets |= BitboardUtils::squareBit(pushCoordinate);
+        while (targets) {
+            const int coordinateToMove{BitboardUtils::popLsb(targets)};
+            if (lastRank[coordinateToMove])
+                moveList.add({coordinateFrom, coordinateToMove,
+                              CompactMove::Flag::PROMOTION,
+                              FigureType::QUEEN});
+            else
+                moveList.add({coordinateFrom, coordinateToMove});
+        }
+        if (enPassantCoordinate != -1 &&
+            BitboardUtils::isSet(attacks, enPassantCoordinate))
+            moveList.add({coordinateFrom, enPassantCoordinate,
+                          CompactMove::Flag::EN_PASSANT});
+    }
+}
+
+void MoveGenerator::generateCaptures(const Position &position,
+                                     MoveList &moveList) {
+    const Color::ColorT color{position.getSideToMove()};
+    const Bitboard occupancy{position.getOccupancy()};
+    const Bitboard targets{
+        position.getFigures(Color::getOppositeColor(color))};
+    addPawnCaptures(position, moveList);
+    for (Bitboard knights{position.getFigures(FigureType::KNIGHT, color)};
+         knights;) {
+        const int coordinate{BitboardUtils::popLsb(knights)};
+        addMoves(coordinate,
+                 BitboardUtils::getKnightAttacks(coordinate) & targets,
+                 moveList);
+    }
+    for (Bitboard bishops{position.getFigures(FigureType::BISHOP, color)};
+         bishops;) {
+        const int coordinate{BitboardUtils::popLsb(bishops)};
+        addMoves(coordinate,
+                 BitboardUtils::getBishopAttacks(coordinate, occupancy) &
+                     targets,
+                 moveList);
+    }
+    for (Bitboard rooks{position.getFigures(FigureType::ROOK, color)};
+         rooks;) {
+        const int coordinate{BitboardUtils::popLsb(rooks)};
+        addMoves(coordinate,
+                 BitboardUtils::getRookAttacks(coordinate, occupancy) &
+                     targets,
+                 moveList);
+    }
+    for (Bitboard queens{position.getFigures(FigureType::QUEEN, color)};
+         queens;) {
+        const int coordinate{BitboardUtils::popLsb(queens)};
+        addMoves(coordinate,
+                 BitboardUtils::getQueenAttacks(coordinate, occupancy) &
+                     targets,
+                 moveList);
+    }
+    if (const int coordinate{position.getKingCoordinate(color)};
+        coordinate != -1)
+        addMoves(coordinate,
+                 BitboardUtils::getKingAttacks(coordinate) & targets,
+                 moveList);
+}
+
+Bitboard MoveGenerator::calculatePinned(const Position &position,
+                                        Color::ColorT color) {
+    const int kingCoordinate{position.getKingCoordinate(color)};
+    const Color::ColorT opponentColor{Color::getOppositeColor(color)};
+    const Bitboard opponentFigures{position.getFigures(opponentColor)};
+    // opponent sliders that would attack the king through own figures
+    const Bitboard snipers{
+        (BitboardUtils::getBishopAttacks(kingCoordinate, opponentFigures) &
+         (position.getFigures(FigureType::BISHOP, opponentColor) |
+          position.getFigures(FigureType::QUEEN, opponentColor))) |
+        (BitboardUtils::getRookAttacks(kingCoordinate, opponentFigures) &
+         (position.getFigures(FigureType::ROOK, opponentColor) |
+          position.getFigures(FigureType::QUEEN, opponentColor)))};
+    Bitboard pinned{};
+    for (Bitboard remaining{snipers}; remaining;) {
+        const Bitboard blockers{
+            BitboardUtils::getBetween(kingCoordinate,
+                                      BitboardUtils::popLsb(remaining)) &
+            position.getOccupancy()};
+        if (BitboardUtils::popCount(blockers) == 1)
+            pinned |= blockers & position.getFigures(color);
+    }
+    return pinned;
+}
+
+void MoveGenerator::addLegalKingMoves(const Position &position,
+                                      MoveList &moveList) {
+    const Color::ColorT color{position.getSideToMove()};
+    const Color::ColorT opponentColor{Color::getOppositeColor(color)};
+    const int kingCoordinate{position.getKingCoordinate(color)};
+    // the king does not block a slider ray away from itself
+    const Bitboard occupancy{position.getOccupancy() &
+                             ~BitboardUtils::squareBit(kingCoordinate)};
+    for (Bitboard targets{BitboardUtils::getKingAttacks(kingCoordinate) &
+                          ~position.getFigures(color)};
+         targets;) {
+        const int coordinateToMove{BitboardUtils::popLsb(targets)};
+        if (!(position.attackersTo(coordinateToMove, occupancy) &
+              position.getFigures(opponentColor)))
+            moveList.add({kingCoordinate, coordinateToMove});
+    }
+}
+
+void MoveGenerator::addLegalPawnMoves(const Position &position,
+                                      Bitboard targets, Bitboard pinned,
+                                      MoveList &moveList) {
+    const Color::ColorT color{position.getSideToMove()};
+    const int kingCoordinate{position.getKingCoordinate(color)};
+    const Bitboard opponentFigures{
+        position.getFigures(Color::getOppositeColor(color))};
+    const int direction{Color::getDirection(color) *
+                        BoardUtils::NUMBER_SQUARE_PER_ROW};
+    const auto &startRank{color == Color::ColorT::WHITE
+                              ? BoardUtils::SECOND_RANK
+                              : BoardUtils::SEVENTH_RANK};
+    const auto &lastRank{color == Color::ColorT::WHITE
+                             ? BoardUtils::EIGHTH_RANK
+                             : BoardUtils::FIRST_RANK};
+    const int enPassantCoordinate{position.getEnPassantCoordinate()};
+    for (Bitboard pawns{position.getFigures(FigureType::PAWN, color)};
+         pawns;) {
+        const int coordinateFrom{BitboardUtils::popLsb(pawns)};
+        const Bitboard attacks{
+            BitboardUtils::getPawnAttacks(color, coordinateFrom)};
+        Bitboard pawnTargets{attacks & opponentFigures};
+        const int pushCoordinate{coordinateFrom + direction};
+        if (BoardUtils::isValidSquareCoordinate(pushCoordinate) &&
+            !position.isOccupied(pushCoordinate)) {
+            pawnTargets |= BitboardUtils::squareBit(pushCoordinate);
+            if (const int jumpCoordinate{pushCoordinate + direction};
+                startRank[coordinateFrom] &&
+                !position.isOccupied(jumpCoordinate))
+                pawnTargets |= BitboardUtils::squareBit(jumpCoordinate);
+        }
+        pawnTargets &= targets;
+        if (BitboardUtils::isSet(pinned, coordinateFrom))
+            pawnTargets &= BitboardUtils::getLine(kingCoordinate,
+                                                  coordinateFrom);
+        while (pawnTargets) {
+            const int coordinateToMove{BitboardUtils::popLsb(pawnTargets)};
+            if (lastRank[coordinateToMove])
+                for (const FigureType promotionType : PROMOTION_TYPES)
+                    moveList.add({coordinateFrom, coordinateToMove,
+                                  CompactMove::Flag::PROMOTION,
+                                  promotionType});
+            else
+                moveList.add({coordinateFrom, coordinateToMove});
+        }
+        // the capture removes two figures from one row, which no pin or
+        // check mask covers, so it is tried on a copy instead
+        if (enPassantCoordinate != -1 &&
+            BitboardUtils::isSet(attacks, enPassantCoordinate)) {
+            const CompactMove move{coordinateFrom, enPassantCoordinate,
+                                   CompactMove::Flag::EN_PASSANT};
+            Position nextPosition{position};
+            nextPosition.makeMove(move);
+            if (!nextPosition.isInCheck(color))
+                moveList.add(move);
+        }
+    }
+}
+
+void MoveGenerator::addLegalFigureMoves(const Position &position,
+                                        Bitboard targets, Bitboard pinned,
+                                        MoveList &moveList) {
+    const Color::ColorT color{position.getSideToMove()};
+    const int kingCoordinate{position.getKingCoordinate(color)};
+    const Bitboard occupancy{position.getOccupancy()};
+    targets &= ~position.getFigures(color);
+    // a pinned knight can never stay on its pin line
+    for (Bitboard figures{position.getFigures(color) &
+                          ~position.getFigures(FigureType::KING) &
+                          ~position.getFigures(FigureType::PAWN) &
+                          ~(position.getFigures(FigureType::KNIGHT) & pinned)};
+         figures;) {
+        const int coordinate{BitboardUtils::popLsb(figures)};
+        Bitboard attacks{};
+        switch (position.getFigureType(coordinate)) {
+            case FigureType::KNIGHT:
+                attacks = BitboardUtils::getKnightAttacks(coordinate);
+                break;
+            case FigureType::BISHOP:
+                attacks = BitboardUtils::getBishopAttacks(coordinate, occupancy);
+                break;
+            case FigureType::ROOK:
+                attacks = BitboardUtils::getRookAttacks(coordinate, occupancy);
+                break;
+            default:
+                attacks = BitboardUtils::getQueenAttacks(coordinate, occupancy);
+                break;
+        }
+        attacks &= targets;
+        if (BitboardUtils::isSet(pinned, coordinate))
+            attacks &= BitboardUtils::getLine(kingCoordinate, coordinate);
+        addMoves(coordinate, attacks, moveList);
+    }
+}
+
+/*
+    The rights say the king and the rook have not moved. The squares between
+    them must be empty and the king may not be in check, pass an attacked
+    square or land on one.
+*/
+void MoveGenerator::addCastlingMoves(const Position &position,
+                                     MoveList &moveList) {
+    const Color::ColorT color{position.getSideToMove()};
+    const Color::ColorT opponentColor{Color::getOppositeColor(color)};
+    const int kingCoordinate{position.getKingCoordinate(color)};
+    const bool isWhite{color == Color::ColorT::WHITE};
+    const int castlingRights{position.getCastlingRights()};
+    auto isFree{[&](int coordinate) {
+        return !position.isOccupied(coordinate) &&
+               !position.isSquareAttacked(coordinate, opponentColor);
+    }};
+    if (castlingRights &
+            (isWhite ? Position::WHITE_KING_SIDE : Position::BLACK_KING_SIDE) &&
+        isFree(kingCoordinate + 1) && isFree(kingCoordinate + 2))
+        moveList.add({kingCoordinate, kingCoordinate + 2,
+                      CompactMove::Flag::CASTLING});
+    if (castlingRights & (isWhite ? Position::WHITE_QUEEN_SIDE
+                                  : Position::BLACK_QUEEN_SIDE) &&
+        isFree(kingCoordinate - 1) && isFree(kingCoordinate - 2) &&
+        !position.isOccupied(kingCoordinate - 3))
+        moveList.add({kingCoordinate, kingCoordinate - 2,
+                      CompactMove::Flag::CASTLING});
+}
+
+void MoveGenerator::generateLegalMoves(const Position &position,
+                                       MoveList &moveList) {
+    const Color::ColorT color{position.getSideToMove()};
+    const int kingCoordinate{position.getKingCoordinate(color)};
+    if (kingCoordinate == -1)
+        return;
+    addLegalKingMoves(position, moveList);
+    const Bitboard checkers{
+        position.attackersTo(kingCoordinate, position.getOccupancy()) &
+        position.getFigures(Color::getOppositeColor(color))};
+    if (BitboardUtils::popCount(checkers) > 1)
+        return;
+    Bitboard targets{~Bitboard{}};
+    if (checkers)
+        targets = checkers | BitboardUtils::getBetween(
+                                 kingCoordinate, BitboardUtils::lsb(checkers));
+    const Bitboard pinned{calculatePinned(position, color)};
+    addLegalPawnMoves(position, targets, pinned, moveList);
+    addLegalFigureMoves(position, targets, pinned, moveList);
+    if (!checkers)
+        addCastlingMoves(position, moveList);
+}
@@ -0,0 +1,511 @@
+#include "nnue.h"
+#include "bitboard.h"
+#include "board_utils.h"
+#include "position.h"
+#include <algorithm>
+#include <cstring>
+#include <fcntl.h>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+/*
+ * The file holds a header, the first layer and the other layers. The header
+ * is the version, a hash of the architecture and the description, preceded
+ * by its size. Each part starts with the hash of its own architecture,
+ * followed by the biases and weights of its layers from the input to the
+ * output, all little-endian. The version and the size of the file leave no
+ * room for another architecture, so the hashes are not checked.
+ */
+Nnue::Nnue(const std::string &path) : kernels(detectKernels()) {
+    const int descriptor{open(path.c_str(), O_RDONLY)};
+    if (descriptor < 0)
+        throw std::runtime_error("Cannot open " + path);
+    struct stat status {};
+    if (fstat(descriptor, &status) < 0) {
+        close(descriptor);
+        throw std::runtime_error("Cannot read " + path);
+    }
+    size = static_cast<std::size_t>(status.st_size);
+    constexpr std::size_t headerSize{3 * sizeof(std::uint32_t)};
+    if (size < headerSize) {
+        close(descriptor);
+        throw std::runtime_error(path + " is not a HalfKP network");
+    }
+    void *mapping{mmap(nullptr, size, PROT_READ, MAP_PRIVATE, descriptor, 0)};
+    close(descriptor);
+    if (mapping == MAP_FAILED)
+        throw std::runtime_error("Cannot map " + path);
+    data = static_cast<const unsigned char *>(mapping);
+    const unsigned char *bytes{data};
+    const std::uint32_t version{readUint32(bytes)};
+    readUint32(bytes);
+    const std::uint32_t descriptionSize{readUint32(bytes)};
+    const std::size_t expectedSize{
+        headerSize + descriptionSize + sizeof(std::uint32_t) +
+        sizeof(inputBiases) +
+        std::size_t{NUMBER_INPUTS} * HALF_DIMENSIONS * sizeof(std::int16_t) +
+        sizeof(std::uint32_t) + sizeof(hiddenBiases1) +
+        sizeof(hiddenWeights1) + sizeof(hiddenBiases2) +
+        sizeof(hiddenWeights2) + sizeof(outputBias) +
+        sizeof(outputWeights)};
+    if (version != VERSION || size != expectedSize) {
+        munmap(mapping, size);
+        throw std::runtime_error(path + " is not a HalfKP network");
+    }
+    description.assign(reinterpret_cast<const char *>(bytes),
+                       descriptionSize);
+    bytes += descriptionSize;
+    readUint32(bytes);
+    read(bytes, inputBiases);
+    inputWeights = bytes;
+    bytes += std::size_t{NUMBER_INPUTS} * HALF_DIMENSIONS *
+             sizeof(std::int16_t);
+    readUint32(bytes);
+    read(bytes, hiddenBiases1);
+    read(bytes, hiddenWeights1);
+    read(bytes, hiddenBiases2);
+    read(bytes, hiddenWeights2);
+    outputBias = static_cast<std::int32_t>(readUint32(bytes));
+    read(bytes, outputWeights);
+    // the rows of the figures on the board are read over and over
+    madvise(mapping, size, MADV_WILLNEED);
+}
+
+Nnue::~Nnue() {
+    munmap(const_cast<unsigned char *>(data), size);
+}
+
+Nnue::Kernels Nnue::detectKernels() {
+#if defined(__x86_64__) || defined(__i386__)
+    if (__builtin_cpu_supports("avx2"))
+        return Kernels::AVX2;
+    if (__builtin_cpu_supports("sse4.1"))
+        return Kernels::SSE41;
+#endif
+    return Kernels::SCALAR;
+}
+
+// Stockfish counts the squares from a1 and turns the board around for
+// black, so its king stays on the first rows
+int Nnue::getInputIndex(Color::ColorT perspective, int kingCoordinate,
+                        FigureType figureType, Color::ColorT color,
+                        int coordinate) {
+    const int orientation{perspective == Color::ColorT::WHITE ? 56 : 7};
+    return (coordinate ^ orientation) + 1 +
+           BoardUtils::NUMBER_SQUARES *
+               (2 * FIGURE_KINDS[static_cast<int>(figureType)] +
+                (color != perspective)) +
+           KING_INPUTS * (kingCoordinate ^ orientation);
+}
+
+const unsigned char *Nnue::getInputRow(int index) const {
+    return inputWeights +
+           std::size_t(index) * HALF_DIMENSIONS * sizeof(std::int16_t);
+}
+
+template <typename T, std::size_t N>
+void Nnue::read(const unsigned char *&bytes, std::array<T, N> &values) {
+    std::memcpy(values.data(), bytes, sizeof(values));
+    bytes += sizeof(values);
+}
+
+std::uint32_t Nnue::readUint32(const unsigned char *&bytes) {
+    std::uint32_t value;
+    std::memcpy(&value, bytes, sizeof(value));
+    bytes += sizeof(value);
+    return value;
+}
+
+void Nnue::addRows(const std::int16_t *source, std::int16_t *values,
+                   const unsigned char *const *addedRows, int numberAdded,
+                   const unsigned char *const *removedRows,
+                   int numberRemoved) const {
+    switch (kernels) {
+#if defined(__x86_64__) || defined(__i386__)
+        case Kernels::AVX2:
+            return addRowsAvx2(source, values, addedRows, numberAdded,
+                               removedRows, numberRemoved);
+        case Kernels::SSE41:
+            return addRowsSse41(source, values, addedRows, numberAdded,
+                                removedRows, numberRemoved);
+#endif
+        default:
+            return addRowsScalar(source, values, addedRows, numberAdded,
+                                 removedRows, numberRemoved);
+    }
+}
+
+void Nnue::transform(const Accumulator &accumulator,
+                     Color::ColorT sideToMove, std::uint8_t *output) const {
+    const int side{static_cast<int>(sideToMove)};
+    for (const int perspective : {side, 1 - side}) {
+        const std::int16_t *values{accumulator.values[perspective].data()};
+        switch (kernels) {
+#if defined(__x86_64__) || defined(__i386__)
+            case Kernels::AVX2:
+                transformAvx2(values, output);
+                break;
+            case Kernels::SSE41:
+                transformSse41(values, output);
+                break;
+#endif
+            default:
+                transformScalar(values, output);
+        }
+        output += HALF_DIMENSIONS;
+    }
+}
+
+void Nnue::affine(const std::uint8_t *input, int inputSize,
+                  const std::int8_t *weights, const std::int32_t *biases,
+                  int outputSize, std::int32_t *output) const {
+    switch (kernels) {
+#if defined(__x86_64__) || defined(__i386__)
+        case Kernels::AVX2:
+            return affineAvx2(input, inputSize, weights, biases, outputSize,
+                              output);
+        case Kernels::SSE41:
+            return affineSse41(input, inputSize, weights, biases, outputSize,
+                               output);
+#endif
+        default:
+            return affineScalar(input, inputSize, weights, biases,
+                                outputSize, output);
+    }
+}
+
+void Nnue::clip(const std::int32_t *sums, int size, std::uint8_t *output) {
+    for (int i{}; i < size; i++)
+        output[i] = static_cast<std::uint8_t>(
+            std::clamp(sums[i] >> WEIGHT_SHIFT, 0, 127));
+}
+
+// the sums wrap around on overflow like the SIMD ones
+void Nnue::addRowsScalar(const std::int16_t *source, std::int16_t *values,
+                         const unsigned char *const *addedRows,
+                         int numberAdded,
+                         const unsigned char *const *removedRows,
+                         int numberRemoved) {
+    std::array<std::int16_t, HALF_DIMENSIONS> row;
+    std::copy(source, source + HALF_DIMENSIONS, values);
+    for (int i{}; i < numberAdded; i++) {
+        std::memcpy(row.data(), addedRows[i], sizeof(row));
+        for (int j{}; j < HALF_DIMENSIONS; j++)
+            values[j] = static_cast<std::int16_t>(values[j] + row[j]);
+    }
+    for (int i{}; i < numberRemoved; i++) {
+        std::memcpy(row.data(), removedRows[i], sizeof(row));
+        for (int j{}; j < HALF_DIMENSIONS; j++)
+            values[j] = static_cast<std::int16_t>(values[j] - row[j]);
+    }
+}
+
+void Nnue::transformScalar(const std::int16_t *values,
+                           std::uint8_t *output) {
+    for (int i{}; i < HALF_DIMENSIONS; i++)
+        output[i] = static_cast<std::uint8_t>(
+            std::clamp<int>(values[i], 0, 127));
+}
+
+void Nnue::affineScalar(const std::uint8_t *input, int inputSize,
+                        const std::int8_t *weights,
+                        const std::int32_t *biases, int outputSize,
+                        std::int32_t *output) {
+    for (int i{}; i < outputSize; i++) {
+        std::int32_t sum{biases[i]};
+        for (int j{}; j < inputSize; j++)
+            sum += weights[i * inputSize + j] * input[j];
+        output[i] = sum;
+    }
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+/*
+ * The SIMD kernels are compiled for their instruction sets whatever the
+ * flags of the build, and only called when the processor has them. The rows
+ * of the mapping may be unaligned, every load is. The affine layers multiply
+ * the unsigned inputs by the signed weights pairwise into 16 bits, which
+ * cannot saturate since the inputs are at most 127, then sum the pairs into
+ * 32 bits.
+ */
+__attribute__((target("sse4.1"))) void
+Nnue::addRowsSse41(const std::int16_t *source, std::int16_t *values,
+                   const unsigned char *const *addedRows, int numberAdded,
+                   const unsigned char *const *removedRows,
+                   int numberRemoved) {
+    constexpr int width{sizeof(__m128i) / sizeof(std::int16_t)};
+    for (int j{}; j < HALF_DIMENSIONS; j += width) {
+        __m128i sum{_mm_loadu_si128(
+            reinterpret_cast<const __m128i *>(source + j))};
+        for (int i{}; i < numberAdded; i++)
+            sum = _mm_add_epi16(sum, _mm_loadu_si128(
+                                         reinterpret_cast<const __m128i *>(
+                                             addedRows[i]) +
+                                         j / width));
+        for (int i{}; i < numberRemoved; i++)
+            sum = _mm_sub_epi16(sum, _mm_loadu_si128(
+                                         reinterpret_cast<const __m128i *>(
+                                             removedRows[i]) +
+                                         j / width));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(values + j), sum);
+    }
+}
+
+__attribute__((target("sse4.1"))) void
+Nnue::transformSse41(const std::int16_t *values, std::uint8_t *output) {
+    constexpr int width{sizeof(__m128i) / sizeof(std::int16_t)};
+    const __m128i zero{_mm_setzero_si128()};
+    for (int i{}; i < HALF_DIMENSIONS; i += 2 * width) {
+        const __m128i low{
+            _mm_loadu_si128(reinterpret_cast<const __m128i *>(values + i))};
+        const __m128i high{_mm_loadu_si128(
+            reinterpret_cast<const __m128i *>(values + i + width))};
+        // saturating to -128..127, then cutting the negative values
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(output + i),
+                         _mm_max_epi8(_mm_packs_epi16(low, high), zero));
+    }
+}
+
+__attribute__((target("sse4.1"))) void
+Nnue::affineSse41(const std::uint8_t *input, int inputSize,
+                  const std::int8_t *weights, const std::int32_t *biases,
+                  int outputSize, std::int32_t *output) {
+    constexpr int width{sizeof(__m128i)};
+    const __m128i ones{_mm_set1_epi16(1)};
+    for (int i{}; i < outputSize; i++) {
+        __m128i sum{_mm_setzero_si128()};
+        for (int j{}; j < inputSize; j += width) {
+            const __m128i products{_mm_maddubs_epi16(
+                _mm_loadu_si128(reinterpret_cast<const __m128i *>(input + j)),
+                _mm_loadu_si128(reinterpret_cast<const __m128i *>(
+                    weights + i * inputSize + j)))};
+            sum = _mm_add_epi32(sum, _mm_madd_epi16(products, ones));
+        }
+        sum = _mm_hadd_epi32(sum, sum);
+        sum = _mm_hadd_epi32(sum, sum);
+        output[i] = _mm_cvtsi128_si32(sum) + biases[i];
+    }
+}
+
+__attribute__((target("avx2"))) void
+Nnue::addRowsAvx2(const std::int16_t *source, std::int16_t *values,
+                  const unsigned char *const *addedRows, int numberAdded,
+                  const unsigned char *const *removedRows,
+                  int numberRemoved) {
+    constexpr int width{sizeof(__m256i) / sizeof(std::int16_t)};
+    for (int j{}; j < HALF_DIMENSIONS; j += width) {
+        __m256i sum{_mm256_loadu_si256(
+            reinterpret_cast<const __m256i *>(source + j))};
+        for (int i{}; i < numberAdded; i++)
+            sum = _mm256_add_epi16(
+                sum, _mm256_loadu_si256(
+                         reinterpret_cast<const __m256i *>(addedRows[i]) +
+                         j / width));
+        for (int i{}; i < numberRemoved; i++)
+            sum = _mm256_sub_epi16(
+                sum, _mm256_loadu_si256(
+                         reinterpret_cast<const __m256i *>(removedRows[i]) +
+                         j / width));
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(values + j), sum);
+    }
+}
+
+__attribute__((target("avx2"))) void
+Nnue::transformAvx2(const std::int16_t *values, std::uint8_t *output) {
+    constexpr int width{sizeof(__m256i) / sizeof(std::int16_t)};
+    const __m256i zero{_mm256_setzero_si256()};
+    for (int i{}; i < HALF_DIMENSIONS; i += 2 * width) {
+        const __m256i low{_mm256_loadu_si256(
+            reinterpret_cast<const __m256i *>(values + i))};
+        const __m256i high{_mm256_loadu_si256(
+            reinterpret_cast<const __m256i *>(values + i + width))};
+        // the packing works on 128 bit lanes, the permutation puts the
+        // quarters back in order
+        const __m256i packed{_mm256_permute4x64_epi64(
+            _mm256_packs_epi16(low, high), 0b11011000)};
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(output + i),
+                            _mm256_max_epi8(packed, zero));
+    }
+}
+
+__attribute__((target("avx2"))) void
+Nnue::affineAvx2(const std::uint8_t *input, int inputSize,
+                 const std::int8_t *weights, const std::int32_t *biases,
+                 int outputSize, std::int32_t *output) {
+    constexpr int width{sizeof(__m256i)};
+    const __m256i ones{_mm256_set1_epi16(1)};
+    for (int i{}; i < outputSize; i++) {
+        __m256i sum{_mm256_setzero_si256()};
+        for (int j{}; j < inputSize; j += width) {
+            const __m256i products{_mm256_maddubs_epi16(
+                _mm256_loadu_si256(
+                    reinterpret_cast<const __m256i *>(input + j)),
+                _mm256_loadu_si256(reinterpret_cast<const __m256i *>(
+                    weights + i * inputSize + j)))};
+            sum = _mm256_add_epi32(sum, _mm256_madd_epi16(products, ones));
+        }
+        __m128i lanes{_mm_add_epi32(_mm256_castsi256_si128(sum),
+                                    _mm256_extracti128_si256(sum, 1))};
+        lanes = _mm_hadd_epi32(lanes, lanes);
+        lanes = _mm_hadd_epi32(lanes, lanes);
+        output[i] = _mm_cvtsi128_si32(lanes) + biases[i];
+    }
+}
+#endif
+
+const std::string &Nnue::getDescription() const {
+    return description;
+}
+
+Nnue::Kernels Nnue::getKernels() const {
+    return kernels;
+}
+
+void Nnue::setKernels(Kernels kernels) {
+    if (kernels > detectKernels())
+        throw std::invalid_argument("Unsupported kernels");
+    this->kernels = kernels;
+}
+
+std::string_view Nnue::getKernelsName(Kernels kernels) {
+    switch (kernels) {
+        case Kernels::AVX2:
+            return "AVX2";
+        case Kernels::SSE41:
+            return "SSE4.1";
+        case Kernels::SCALAR:
+            break;
+    }
+    return "scalar";
+}
+
+void Nnue::refresh(const Position &position, Color::ColorT perspective,
+                   Accumulator &accumulator) const {
+    const int kingCoordinate{position.getKingCoordinate(perspective)};
+    std::array<const unsigned char *, MAX_ACTIVE_INPUTS> rows;
+    int numberRows{};
+    Bitboard figures{position.getOccupancy() &
+                     ~position.getFigures(FigureType::KING)};
+    while (figures) {
+        const int coordinate{BitboardUtils::popLsb(figures)};
+        rows[numberRows++] = getInputRow(getInputIndex(
+            perspective, kingCoordinate, position.getFigureType(coordinate),
+            position.getColor(coordinate), coordinate));
+    }
+    addRows(inputBiases.data(),
+            accumulator.values[static_cast<int>(perspective)].data(),
+            rows.data(), numberRows, nullptr, 0);
+}
+
+void Nnue::update(const Accumulator &previous, const MoveChanges &changes,
+                  Color::ColorT perspective, int kingCoordinate,
+                  Accumulator &accumulator) const {
+    std::array<const unsigned char *, 3> addedRows;
+    std::array<const unsigned char *, 3> removedRows;
+    int numberAdded{};
+    int numberRemoved{};
+    for (int i{}; i < changes.size; i++) {
+        const FigureChange &change{changes.changes[i]};
+        if (change.figureType == FigureType::KING)
+            continue;
+        if (change.coordinateFrom >= 0)
+            removedRows[numberRemoved++] = getInputRow(
+                getInputIndex(perspective, kingCoordinate, change.figureType,
+                              change.color, change.coordinateFrom));
+        if (change.coordinateToMove >= 0)
+            addedRows[numberAdded++] = getInputRow(
+                getInputIndex(perspective, kingCoordinate, change.figureType,
+                              change.color, change.coordinateToMove));
+    }
+    const int side{static_cast<int>(perspective)};
+    addRows(previous.values[side].data(), accumulator.values[side].data(),
+            addedRows.data(), numberAdded, removedRows.data(), numberRemoved);
+}
+
+int Nnue::evaluate(const Accumulator &accumulator,
+                   Color::ColorT sideToMove) const {
+    alignas(32) std::array<std::uint8_t, 2 * HALF_DIMENSIONS> transformed;
+    alignas(32) std::array<std::int32_t, HIDDEN_DIMENSIONS> sums;
+    alignas(32) std::array<std::uint8_t, HIDDEN_DIMENSIONS> hidden1;
+    alignas(32) std::array<std::uint8_t, HIDDEN_DIMENSIONS> hidden2;
+    transform(accumulator, sideToMove, transformed.data());
+    affine(transformed.data(), 2 * HALF_DIMENSIONS, hiddenWeights1.data(),
+           hiddenBiases1.data(), HIDDEN_DIMENSIONS, sums.data());
+    clip(sums.data(), HIDDEN_DIMENSIONS, hidden1.data());
+    affine(hidden1.data(), HIDDEN_DIMENSIONS, hiddenWeights2.data(),
+           hiddenBiases2.data(), HIDDEN_DIMENSIONS, sums.data());
+    clip(sums.data(), HIDDEN_DIMENSIONS, hidden2.data());
+    std::int32_t output;
+    affine(hidden2.data(), HIDDEN_DIMENSIONS, outputWeights.data(),
+           &outputBias, 1, &output);
+    return output / OUTPUT_SCALE * 100 / PAWN_VALUE;
+}
+
+int Nnue::evaluate(const Position &position) const {
+    Accumulator accumulator;
+    refresh(position, Color::ColorT::WHITE, accumulator);
+    refresh(position, Color::ColorT::BLACK, accumulator);
+    return evaluate(accumulator, position.getSideToMove());
+}
+
+Nnue::MoveChanges Nnue::getMoveChanges(const Position &position,
+                                       CompactMove move) {
+    const int coordinateFrom{move.getCoordinateFrom()};
+    const int coordinateToMove{move.getCoordinateToMove()};
+    const FigureType figureType{position.getFigureType(coordinateFrom)};
+    const Color::ColorT color{position.getSideToMove()};
+    const Color::ColorT opponent{Color::getOppositeColor(color)};
+    MoveChanges changes;
+    auto addChange{[&changes](FigureType figureType, Color::ColorT color,
+                              int coordinateFrom, int coordinateToMove) {
+        changes.changes[changes.size++] = {figureType, color, coordinateFrom,
+                                           coordinateToMove};
+    }};
+    switch (move.getFlag()) {
+        case CompactMove::Flag::NORMAL:
+            if (position.isOccupied(coordinateToMove))
+                addChange(position.getFigureType(coordinateToMove), opponent,
+                          coordinateToMove, -1);
+            addChange(figureType, color, coordinateFrom, coordinateToMove);
+            break;
+        case CompactMove::Flag::PROMOTION:
+            if (position.isOccupied(coordinateToMove))
+                addChange(position.getFigureType(coordinateToMove), opponent,
+                          coordinateToMove, -1);
+            addChange(FigureType::PAWN, color, coordinateFrom, -1);
+            addChange(move.getPromotionType(), color, -1, coordinateToMove);
+            break;
+        case CompactMove::Flag::EN_PASSANT:
+            addChange(FigureType::PAWN, opponent,
+                      coordinateToMove - Color::getDirection(color) *
+                                             BoardUtils::NUMBER_SQUARE_PER_ROW,
+                      -1);
+            addChange(FigureType::PAWN, color, coordinateFrom,
+                      coordinateToMove);
+            break;
+        case CompactMove::Flag::CASTLING:
+            addChange(FigureType::KING, color, coordinateFrom,
+                      coordinateToMove);
+            if (coordinateToMove > coordinateFrom)
+                addChange(FigureType::ROOK, color, coordinateFrom + 3,
+                          coordinateFrom + 1);
+            else
+                addChange(FigureType::ROOK, color, coordinateFrom - 4,
+                          coordinateFrom - 1);
+            break;
+    }
+    return changes;
+}
+
+bool Nnue::movesKing(const MoveChanges &changes, Color::ColorT color) {
+    for (int i{}; i < changes.size; i++)
+        if (changes.changes[i].figureType == FigureType::KING &&
+            changes.changes[i].color == color)
+            return true;
+    return false;
+}
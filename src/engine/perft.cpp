@@ -0,0 +1,230 @@
+#include "perft.h"
+#include "board.h"
+#include "epd_file.h"
+#include "fen.h"
+#include "figure.h"
+#include "move.h"
+#include "move_generator.h"
+#include "player.h"
+#include <chrono>
+#include <format>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+
+PerftCache::PerftCache(std::size_t megabytes)
+    : entries(std::max<std::size_t>(megabytes * 1024 * 1024 / sizeof(Entry),
+                                    1)) {
+}
+
+bool PerftCache::probe(std::uint64_t key, int depth,
+                       std::uint64_t &nodes) const {
+    const Entry &entry{entries[key % entries.size()]};
+    if (entry.key != key || entry.depth != depth)
+        return false;
+    nodes = entry.nodes;
+    return true;
+}
+
+void PerftCache::store(std::uint64_t key, int depth, std::uint64_t nodes) {
+    entries[key % entries.size()] = {key, nodes, depth};
+}
+
+std::uint64_t Perft::perft(const Position &position, int depth, bool bulk,
+                           PerftCache *cache) {
+    if (!depth)
+        return 1;
+    std::uint64_t nodes{};
+    const std::uint64_t key{position.getKey()};
+    if (cache && cache->probe(key, depth, nodes))
+        return nodes;
+    MoveList moveList;
+    MoveGenerator::generateLegalMoves(position, moveList);
+    if (bulk && depth == 1)
+        return moveList.getSize();
+    for (const CompactMove move : moveList) {
+        Position nextPosition{position};
+        nextPosition.makeMove(move);
+        nodes += perft(nextPosition, depth - 1, bulk, cache);
+    }
+    if (cache)
+        cache->store(key, depth, nodes);
+    return nodes;
+}
+
+std::uint64_t Perft::divide(const Position &position, int depth, bool bulk,
+                            PerftCache *cache) {
+    MoveList moveList;
+    MoveGenerator::generateLegalMoves(position, moveList);
+    std::uint64_t nodes{};
+    for (const CompactMove move : moveList) {
+        Position nextPosition{position};
+        nextPosition.makeMove(move);
+        const std::uint64_t moveNodes{
+            perft(nextPosition, depth - 1, bulk, cache)};
+        std::cout << std::format("{}: {}\n", move.toString(), moveNodes);
+        nodes += moveNodes;
+    }
+    return nodes;
+}
+
+/*
+    Each node gets players of its own, so the legal moves of a node stay valid
+    in the arena of its player while the moves below them are counted. The
+    player's list only keeps the figure moves MoveGenerator finds legal, so a
+    move the figures fail to produce is missing from it and nothing else.
+*/
+std::uint64_t Perft::perftBoard(Board &board, int depth, bool bulk) {
+    const Position &position{board.getPosition()};
+    const Color::ColorT color{position.getSideToMove()};
+    const bool inCheck{position.isInCheck(color)};
+    std::unique_ptr<Player> player;
+    if (color == Color::ColorT::WHITE)
+        player = std::make_unique<WhitePlayer>(board.getKing(color), inCheck);
+    else
+        player = std::make_unique<BlackPlayer>(board.getKing(color), inCheck);
+    player->updateLegalMoves(board);
+    MoveList moveList;
+    MoveGenerator::generateLegalMoves(position, moveList);
+    for (const CompactMove move : moveList)
+        if (!player->getLegalMove(move))
+            throw std::runtime_error(
+                std::format("{}: {} is missing from the legal moves of the "
+                            "player",
+                            Fen::write(position), move.toString()));
+    if (player->getLegalMoves().size() !=
+        static_cast<std::size_t>(moveList.getSize()))
+        throw std::runtime_error(std::format(
+            "{}: the player has {} legal moves, MoveGenerator {}",
+            Fen::write(position), player->getLegalMoves().size(),
+            moveList.getSize()));
+    if (depth == 1 && bulk)
+        return moveList.getSize();
+    std::uint64_t nodes{};
+    for (const auto &move : player->getLegalMoves()) {
+        MoveUndo undo{board.makeMove(*move)};
+        nodes += depth > 1 ? perftBoard(board, depth - 1, bulk) : 1;
+        board.unmakeMove(*move, undo);
+    }
+    return nodes;
+}
+
+/*
+    Every record of the file is counted to the depth and checked against its
+    D<depth> operation when it has one, as in the perft suites.
+*/
+int Perft::runSuite(const std::string &path, int depth, bool bulk,
+                    PerftCache *cache) {
+    const std::string depthOpcode{"D" + std::to_string(depth)};
+    std::uint64_t nodes{};
+    int positions{};
+    int failures{};
+    const auto start{std::chrono::steady_clock::now()};
+    try {
+        EpdFile epdFile(path);
+        Position position;
+        for (std::string_view line; epdFile.nextLine(line);) {
+            const std::string_view operations{Fen::parseEpd(line, position)};
+            const std::uint64_t positionNodes{
+                perft(position, depth, bulk, cache)};
+            const std::string_view expected{
+                Fen::getOperation(operations, depthOpcode)};
+            positions++;
+            nodes += positionNodes;
+            if (!expected.empty() &&
+                std::to_string(positionNodes) != expected) {
+                failures++;
+                std::cerr << std::format("{}: {} nodes, expected {}\n",
+                                         Fen::write(position), positionNodes,
+                                         expected);
+            }
+        }
+    } catch (const std::exception &ex) {
+        std::cerr << ex.what() << '\n';
+        return 1;
+    }
+    const auto milliseconds{
+        std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - start)
+            .count()};
+    std::cout << std::format(
+        "Positions: {}\nFailed: {}\nNodes: {}\nTime: {} ms\nNPS: {}\n",
+        positions, failures, nodes, milliseconds,
+        nodes * 1000 / std::max<long long>(milliseconds, 1));
+    return failures ? 1 : 0;
+}
+
+int Perft::run(const std::vector<std::string> &arguments) {
+    int depth{};
+    std::string fen{Fen::START_POSITION};
+    std::string epdPath;
+    bool bulk{};
+    bool isBoard{};
+    std::size_t hashMegabytes{};
+    std::uint64_t expectedNodes{};
+    try {
+        if (arguments.empty())
+            throw std::invalid_argument("missing depth");
+        depth = std::stoi(arguments[0]);
+        for (std::size_t i{1}; i < arguments.size(); i++) {
+            if (arguments[i] == "--bulk")
+                bulk = true;
+            else if (arguments[i] == "--hash" && i + 1 < arguments.size())
+                hashMegabytes = std::stoul(arguments[++i]);
+            else if (arguments[i] == "--expect" && i + 1 < arguments.size())
+                expectedNodes = std::stoull(arguments[++i]);
+            else if (arguments[i] == "--epd" && i + 1 < arguments.size())
+                epdPath = arguments[++i];
+            else if (arguments[i] == "--board")
+                isBoard = true;
+            else if (i == 1)
+                fen = arguments[i];
+            else
+                throw std::invalid_argument(arguments[i]);
+        }
+        if (depth < 1)
+            throw std::invalid_argument("depth must be positive");
+        // the board has no key for the cache and is built from one FEN
+        if (isBoard && (hashMegabytes || !epdPath.empty()))
+            throw std::invalid_argument("--board");
+    } catch (const std::logic_error &ex) {
+        std::cerr << "Usage: Chess perft <depth> [fen] [--bulk] [--hash <MB>] "
+                     "[--expect <nodes>] [--epd <file>] [--board]\n";
+        return 1;
+    }
+    std::unique_ptr<PerftCache> cache(
+        hashMegabytes ? std::make_unique<PerftCache>(hashMegabytes) : nullptr);
+    if (!epdPath.empty())
+        return runSuite(epdPath, depth, bulk, cache.get());
+    Position position;
+    try {
+        Fen::parse(fen, position);
+    } catch (const std::invalid_argument &ex) {
+        std::cerr << ex.what() << '\n';
+        return 1;
+    }
+    const auto start{std::chrono::steady_clock::now()};
+    std::uint64_t nodes{};
+    if (isBoard)
+        try {
+            Board board(fen);
+            nodes = perftBoard(board, depth, bulk);
+        } catch (const std::runtime_error &ex) {
+            std::cerr << ex.what() << '\n';
+            return 1;
+        }
+    else
+        nodes = divide(position, depth, bulk, cache.get());
+    const auto milliseconds{
+        std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - start)
+            .count()};
+    std::cout << std::format(
+        "\nNodes: {}\nTime: {} ms\nNPS: {}\n", nodes, milliseconds,
+        nodes * 1000 / std::max<long long>(milliseconds, 1));
+    if (expectedNodes && nodes != expectedNodes) {
+        std::cerr << std::format("Expected {} nodes\n", expectedNodes);
+        return 1;
+    }
+    return 0;
+}
@@ -3,88 +3,85 @@
 #include "figure.h"
 #include "figure_type.h"
 #include "move.h"
+#include "move_generator.h"
 
-Player::Player(King *king, std::vector<std::unique_ptr<Move>> &&legalMoves,
-               bool inCheck)
-    : playerKing(king), legalMoves(std::move(legalMoves)), inCheck(inCheck) {
+Player::Player(King *king, bool inCheck)
+    : playerKing(king), inCheck(inCheck) {
 }
 
 Player::Player(const Player &player)
     : playerKing(player.playerKing), inCheck(player.inCheck) {
+    legalMoves.reserve(player.legalMoves.size());
     for (auto &move : player.legalMoves)
-        legalMoves.push_back(move->clone());
+        legalMoves.push_back(move->clone(arena));
 }
 
-std::vector<Move *> Player::calculateAttackOnSquare(
-    int coordinate, const std::vector<std::unique_ptr<Move>> &moves) {
-    std::vector<Move *> attackMoves;
-    for (const auto &move : moves)
-        if (move->getCoordinateToMove() == coordinate)
-            attackMoves.push_back(move.get());
-    return attackMoves;
+bool Player::isKingAttacked(const Board &board) const {
+    return board.isSquareAttacked(playerKing->getCoordinate(),
+                                  Color::getOppositeColor(getColor()));
 }
 
-bool Player::hasAttackOnKing(
-    const std::vector<std::unique_ptr<Move>> &opponentMoves) {
-    std::vector<Move *> attacksOnKing{
-        calculateAttackOnSquare(playerKing->getCoordinate(), opponentMoves)};
-    return !(attacksOnKing.empty());
+bool Player::isCastlePassAttacked(const Board &board, int coordinate) const {
+    return board.isSquareAttacked(coordinate,
+                                  Color::getOppositeColor(getColor()));
 }
 
-bool Player::hasAttackOnKing(
-    const King *king, const std::vector<std::unique_ptr<Move>> &opponentMoves) {
-    std::vector<Move *> attacksOnKing{
-        calculateAttackOnSquare(king->getCoordinate(), opponentMoves)};
-    return !(attacksOnKing.empty());
+MoveVector &Player::getLegalMoves() {
+    return legalMoves;
 }
 
-bool Player::hasEscapeMoves(Board &board, Player *opponent) {
-    std::unique_ptr<Board> movedBoard;
-    std::vector<std::unique_ptr<Move>> opponentMoves;
-    for (auto &move : legalMoves) {
-        movedBoard = move->execute(board);
-        opponentMoves = movedBoard->calculateLegalMoves(opponent->getColor());
-        if (!hasAttackOnKing(movedBoard->getKing(getColor()), opponentMoves))
-            return true;
-    }
-    return false;
+const Arena &Player::getArena() const {
+    return arena;
 }
 
-std::vector<std::unique_ptr<Move>> &Player::getLegalMoves() {
-    return legalMoves;
+Move *Player::getLegalMove(CompactMove compactMove) const {
+    for (const auto &move : legalMoves)
+        if (move->toCompactMove() == compactMove)
+            return move.get();
+    return nullptr;
 }
 
-std::vector<std::unique_ptr<Move>> Player::calculateAllLegalMoves(
-    Board &board, const std::vector<std::unique_ptr<Move>> &opponentMoves) {
-    auto moves(board.calculateLegalMoves(getColor()));
-    auto castleMove(calculateCastleMoves(board, opponentMoves));
-    for (auto &move : castleMove)
-        moves.push_back(std::move(move));
+MoveVector Player::calculateAllLegalMoves(Board &board) {
+    MoveVector moves{board.calculateLegalMoves(getColor(), arena)};
+    calculateCastleMoves(board, moves);
+    Position position{board.getPosition()};
+    if (position.getSideToMove() != getColor()) {
+        position.setSideToMove(getColor());
+        position.setEnPassantCoordinate(-1);
+    }
+    MoveList legalMoveList;
+    MoveGenerator::generateLegalMoves(position, legalMoveList);
+    std::erase_if(moves, [&legalMoveList](const MovePtr &move) {
+        return !legalMoveList.contains(move->toCompactMove());
+    });
     return moves;
 }
 
+// the old moves are destroyed before the memory under them is released
+void Player::updateLegalMoves(Board &board) {
+    legalMoves = MoveVector{&arena};
+    arena.release();
+    legalMoves = calculateAllLegalMoves(board);
+}
+
 MoveStatus Player::makeMove(Move *move, Board &board, Player *opponent) {
-    std::unique_ptr<Board> movedBoard(move->execute(board));
-    std::vector<std::unique_ptr<Move>> opponentMoves(
-        movedBoard->calculateLegalMoves(opponent->getColor()));
-    King *movedPlayerKing{movedBoard->getKing(getColor())};
-    if (hasAttackOnKing(movedPlayerKing, opponentMoves))
+    MoveUndo undo{board.makeMove(*move)};
+    if (isKingAttacked(board)) {
+        board.unmakeMove(*move, undo);
         return MoveStatus::LEAVE_PLAYER_IN_CHEK;
-    else {
-        playerKing = movedPlayerKing;
-        legalMoves = calculateAllLegalMoves(*movedBoard, opponentMoves);
+    } else {
         if (inCheck) {
             inCheck = false;
             playerKing->inCheck = false;
         }
-        opponent->playerKing = movedBoard->getKing(opponent->getColor());
-        opponent->legalMoves =
-            opponent->calculateAllLegalMoves(*movedBoard, legalMoves);
-        if (opponent->hasAttackOnKing(legalMoves)) {
+        // the move is owned by legalMoves and must not be used after this
+        updateLegalMoves(board);
+        // the check flag must be set first, castling is not allowed in check
+        if (opponent->isKingAttacked(board)) {
             opponent->inCheck = true;
             opponent->playerKing->inCheck = true;
         }
-        board = std::move(*movedBoard);
+        opponent->updateLegalMoves(board);
         return MoveStatus::DONE;
     }
 }
@@ -93,24 +90,21 @@ bool Player::isInCheck() const {
     return inCheck;
 }
 
-bool Player::isInCheckMate(Board &board, Player *opponent) {
-    return (inCheck && !hasEscapeMoves(board, opponent));
+bool Player::isInCheckMate() const {
+    return inCheck && legalMoves.empty();
 }
 
-std::vector<std::unique_ptr<Move>> WhitePlayer::calculateCastleMoves(
-    Board &board, const std::vector<std::unique_ptr<Move>> &opponentMoves) {
-    std::vector<std::unique_ptr<Move>> castleMoves;
+void WhitePlayer::calculateCastleMoves(Board &board, MoveVector &moves) {
     if (playerKing->isFirstMove() && !inCheck) {
         if (!board.getSquare(61)->isSquareOccupied() &&
             !board.getSquare(62)->isSquareOccupied()) {
             Square *rookSquare{board.getSquare(63)};
             if (rookSquare->isSquareOccupied() &&
                 rookSquare->getFigureOnSquare()->isFirstMove()) {
-                if (calculateAttackOnSquare(61, opponentMoves).empty() &&
-                    calculateAttackOnSquare(62, opponentMoves).empty() &&
-                    rookSquare->getFigureOnSquare()->getFigureType() ==
-                        FigureType::ROOK)
-                    castleMoves.push_back(std::make_unique<KingSideCastleMove>(
+                if (rookSquare->getFigureOnSquare()->getFigureType() ==
+                        FigureType::ROOK &&
+                    !isCastlePassAttacked(board, 61))
+                    moves.push_back(arena.make<KingSideCastleMove>(
                         playerKing, 62, rookSquare->getFigureOnSquare(), 61));
             }
         }
@@ -120,17 +114,14 @@ std::vector<std::unique_ptr<Move>> WhitePlayer::calculateCastleMoves(
             Square *rookSquare{board.getSquare(56)};
             if (rookSquare->isSquareOccupied() &&
                 rookSquare->getFigureOnSquare()->isFirstMove()) {
-                if (calculateAttackOnSquare(59, opponentMoves).empty() &&
-                    calculateAttackOnSquare(58, opponentMoves).empty() &&
-                    calculateAttackOnSquare(57, opponentMoves).empty() &&
-                    rookSquare->getFigureOnSquare()->getFigureType() ==
-                        FigureType::ROOK)
-                    castleMoves.push_back(std::make_unique<QueenSideCastleMove>(
+                if (rookSquare->getFigureOnSquare()->getFigureType() ==
+                        FigureType::ROOK &&
+                    !isCastlePassAttacked(board, 59))
+                    moves.push_back(arena.make<QueenSideCastleMove>(
                         playerKing, 58, rookSquare->getFigureOnSquare(), 59));
             }
         }
     }
-    return castleMoves;
 }
 
 Color::ColorT WhitePlayer::getColor() const {
@@ -141,21 +132,18 @@ std::string WhitePlayer::getPlayerName() const {
     return "White player";
 }
 
-std::vector<std::unique_ptr<Move>> BlackPlayer::calculateCastleMoves(
-    Board &board, const std::vector<std::unique_ptr<Move>> &opponentMoves) {
-    std::vector<std::unique_ptr<Move>> castleMoves;
+void BlackPlayer::calculateCastleMoves(Board &board, MoveVector &moves) {
     if (playerKing->isFirstMove() && !inCheck) {
         if (!board.getSquare(5)->isSquareOccupied() &&
             !board.getSquare(6)->isSquareOccupied()) {
             Square *rookSquare{board.getSquare(7)};
             if (rookSquare->isSquareOccupied() &&
                 rookSquare->getFigureOnSquare()->isFirstMove()) {
-                if (calculateAttackOnSquare(5, opponentMoves).empty() &&
-                    calculateAttackOnSquare(6, opponentMoves).empty() &&
-                    rookSquare->getFigureOnSquare()->getFigureType() ==
-                        FigureType::ROOK)
-                    castleMoves.push_back(std::make_unique<KingSideCastleMove>(
-                        playerKing, 5, rookSquare->getFigureOnSquare(), 6));
+                if (rookSquare->getFigureOnSquare()->getFigureType() ==
+                        FigureType::ROOK &&
+                    !isCastlePassAttacked(board, 5))
+                    moves.push_back(arena.make<KingSideCastleMove>(
+                        playerKing, 6, rookSquare->getFigureOnSquare(), 5));
             }
         }
         if (!board.getSquare(1)->isSquareOccupied() &&
@@ -164,17 +152,14 @@ std::vector<std::unique_ptr<Move>> BlackPlayer::calculateCastleMoves(
             Square *rookSquare{board.getSquare(0)};
             if (rookSquare->isSquareOccupied() &&
                 rookSquare->getFigureOnSquare()->isFirstMove()) {
-                if (calculateAttackOnSquare(1, opponentMoves).empty() &&
-                    calculateAttackOnSquare(2, opponentMoves).empty() &&
-                    calculateAttackOnSquare(3, opponentMoves).empty() &&
-                    rookSquare->getFigureOnSquare()->getFigureType() ==
-                        FigureType::ROOK)
-                    castleMoves.push_back(std::make_unique<QueenSideCastleMove>(
+                if (rookSquare->getFigureOnSquare()->getFigureType() ==
+                        FigureType::ROOK &&
+                    !isCastlePassAttacked(board, 3))
+                    moves.push_back(arena.make<QueenSideCastleMove>(
                         playerKing, 2, rookSquare->getFigureOnSquare(), 3));
             }
         }
     }
-    return castleMoves;
 }
 
 Color::ColorT BlackPlayer::getColor() const {
@@ -0,0 +1,278 @@
+#include "position.h"
+#include <cstdlib>
+#include <type_traits>
+
+static_assert(std::is_trivially_copyable_v<Position>);
+
+void Position::addFigure(FigureType figureType, Color::ColorT color,
+                         int coordinate) {
+    const Bitboard bit{BitboardUtils::squareBit(coordinate)};
+    materialKey ^= Zobrist::getMaterialKey(
+        figureType, color,
+        BitboardUtils::popCount(getFigures(figureType, color)));
+    figureBoards[static_cast<int>(figureType)] |= bit;
+    colorBoards[static_cast<int>(color)] |= bit;
+    occupancy |= bit;
+    mailbox[coordinate] = static_cast<std::uint8_t>(figureType) + 1;
+    key ^= Zobrist::getFigureKey(figureType, color, coordinate);
+    if (figureType == FigureType::PAWN)
+        pawnKey ^= Zobrist::getFigureKey(figureType, color, coordinate);
+    middlegameScore +=
+        Evaluation::getMiddlegameValue(figureType, color, coordinate);
+    endgameScore += Evaluation::getEndgameValue(figureType, color, coordinate);
+    phase += Evaluation::getPhaseWeight(figureType);
+}
+
+void Position::removeFigure(int coordinate) {
+    const Bitboard bit{BitboardUtils::squareBit(coordinate)};
+    const FigureType figureType{getFigureType(coordinate)};
+    const Color::ColorT color{getColor(coordinate)};
+    key ^= Zobrist::getFigureKey(figureType, color, coordinate);
+    if (figureType == FigureType::PAWN)
+        pawnKey ^= Zobrist::getFigureKey(figureType, color, coordinate);
+    middlegameScore -=
+        Evaluation::getMiddlegameValue(figureType, color, coordinate);
+    endgameScore -= Evaluation::getEndgameValue(figureType, color, coordinate);
+    phase -= Evaluation::getPhaseWeight(figureType);
+    figureBoards[static_cast<int>(figureType)] &= ~bit;
+    colorBoards[static_cast<int>(color)] &= ~bit;
+    occupancy &= ~bit;
+    mailbox[coordinate] = 0;
+    materialKey ^= Zobrist::getMaterialKey(
+        figureType, color,
+        BitboardUtils::popCount(getFigures(figureType, color)));
+}
+
+void Position::moveFigure(int coordinate, int coordinateToMove) {
+    const FigureType figureType{getFigureType(coordinate)};
+    const Color::ColorT color{getColor(coordinate)};
+    if (isOccupied(coordinateToMove))
+        removeFigure(coordinateToMove);
+    removeFigure(coordinate);
+    addFigure(figureType, color, coordinateToMove);
+}
+
+Color::ColorT Position::getSideToMove() const {
+    return sideToMove;
+}
+
+void Position::setSideToMove(Color::ColorT color) {
+    if (color != sideToMove)
+        key ^= Zobrist::getSideKey();
+    sideToMove = color;
+}
+
+int Position::getCastlingRights() const {
+    return castlingRights;
+}
+
+void Position::setCastlingRights(int castlingRights) {
+    key ^= Zobrist::getCastlingKey(this->castlingRights) ^
+           Zobrist::getCastlingKey(castlingRights);
+    this->castlingRights = castlingRights;
+}
+
+int Position::getEnPassantCoordinate() const {
+    return enPassantCoordinate;
+}
+
+void Position::setEnPassantCoordinate(int coordinate) {
+    key ^= Zobrist::getEnPassantKey(enPassantCoordinate) ^
+           Zobrist::getEnPassantKey(coordinate);
+    enPassantCoordinate = coordinate;
+}
+
+int Position::getHalfmoveClock() const {
+    return halfmoveClock;
+}
+
+void Position::setHalfmoveClock(int halfmoveClock) {
+    this->halfmoveClock = halfmoveClock;
+}
+
+int Position::getFullmoveNumber() const {
+    return fullmoveNumber;
+}
+
+void Position::setFullmoveNumber(int fullmoveNumber) {
+    this->fullmoveNumber = fullmoveNumber;
+}
+
+std::uint64_t Position::getKey() const {
+    return key;
+}
+
+std::uint64_t Position::calculateKey() const {
+    std::uint64_t calculatedKey{Zobrist::getCastlingKey(castlingRights) ^
+                                Zobrist::getEnPassantKey(enPassantCoordinate)};
+    if (sideToMove == Color::ColorT::BLACK)
+        calculatedKey ^= Zobrist::getSideKey();
+    for (Bitboard occupied{occupancy}; occupied;) {
+        const int coordinate{BitboardUtils::popLsb(occupied)};
+        calculatedKey ^= Zobrist::getFigureKey(
+            getFigureType(coordinate), getColor(coordinate), coordinate);
+    }
+    return calculatedKey;
+}
+
+std::uint64_t Position::getPawnKey() const {
+    return pawnKey;
+}
+
+std::uint64_t Position::getMaterialKey() const {
+    return materialKey;
+}
+
+int Position::getMiddlegameScore() const {
+    return middlegameScore;
+}
+
+int Position::getEndgameScore() const {
+    return endgameScore;
+}
+
+int Position::getPhase() const {
+    return phase;
+}
+
+void Position::makeMove(CompactMove move) {
+    const int coordinateFrom{move.getCoordinateFrom()};
+    const int coordinateToMove{move.getCoordinateToMove()};
+    const Color::ColorT color{sideToMove};
+    const FigureType figureType{getFigureType(coordinateFrom)};
+    halfmoveClock = isIrreversible(move) ? 0 : halfmoveClock + 1;
+    setEnPassantCoordinate(-1);
+    switch (move.getFlag()) {
+        case CompactMove::Flag::NORMAL:
+            moveFigure(coordinateFrom, coordinateToMove);
+            if (figureType == FigureType::PAWN &&
+                std::abs(coordinateToMove - coordinateFrom) ==
+                    2 * BoardUtils::NUMBER_SQUARE_PER_ROW)
+                setEnPassantCoordinate((coordinateFrom + coordinateToMove) /
+                                       2);
+            break;
+        case CompactMove::Flag::PROMOTION:
+            if (isOccupied(coordinateToMove))
+                removeFigure(coordinateToMove);
+            removeFigure(coordinateFrom);
+            addFigure(move.getPromotionType(), color, coordinateToMove);
+            break;
+        case CompactMove::Flag::EN_PASSANT:
+            moveFigure(coordinateFrom, coordinateToMove);
+            removeFigure(coordinateToMove -
+                         Color::getDirection(color) *
+                             BoardUtils::NUMBER_SQUARE_PER_ROW);
+            break;
+        case CompactMove::Flag::CASTLING:
+            moveFigure(coordinateFrom, coordinateToMove);
+            if (coordinateToMove > coordinateFrom)
+                moveFigure(coordinateFrom + 3, coordinateFrom + 1);
+            else
+                moveFigure(coordinateFrom - 4, coordinateFrom - 1);
+            break;
+    }
+    if (castlingRights)
+        setCastlingRights(castlingRights & ~(CASTLING_MASKS[coordinateFrom] |
+                                             CASTLING_MASKS[coordinateToMove]));
+    if (color == Color::ColorT::BLACK)
+        fullmoveNumber++;
+    setSideToMove(Color::getOppositeColor(color));
+}
+
+Bitboard Position::getOccupancy() const {
+    return occupancy;
+}
+
+Bitboard Position::getFigures(FigureType figureType) const {
+    return figureBoards[static_cast<int>(figureType)];
+}
+
+Bitboard Position::getFigures(Color::ColorT color) const {
+    return colorBoards[static_cast<int>(color)];
+}
+
+Bitboard Position::getFigures(FigureType figureType,
+                              Color::ColorT color) const {
+    return getFigures(figureType) & getFigures(color);
+}
+
+bool Position::isOccupied(int coordinate) const {
+    return mailbox[coordinate];
+}
+
+FigureType Position::getFigureType(int coordinate) const {
+    return static_cast<FigureType>(mailbox[coordinate] - 1);
+}
+
+Color::ColorT Position::getColor(int coordinate) const {
+    return BitboardUtils::isSet(getFigures(Color::ColorT::WHITE), coordinate)
+               ? Color::ColorT::WHITE
+               : Color::ColorT::BLACK;
+}
+
+int Position::getKingCoordinate(Color::ColorT color) const {
+    const Bitboard king{getFigures(FigureType::KING, color)};
+    return king ? BitboardUtils::lsb(king) : -1;
+}
+
+int Position::getMaterial(Color::ColorT color) const {
+    int material{};
+    for (int figureType{}; figureType < NUMBER_FIGURE_TYPES; figureType++)
+        material += BitboardUtils::popCount(figureBoards[figureType] &
+                                            getFigures(color)) *
+                    FIGURE_VALUES[figureType];
+    return material;
+}
+
+/*
+    Looks outward from the square: a figure of the color attacks it exactly
+    when the same figure standing on the square would attack that figure.
+*/
+bool Position::isSquareAttacked(int coordinate, Color::ColorT byColor) const {
+    const Bitboard diagonalSliders{getFigures(FigureType::BISHOP, byColor) |
+                                   getFigures(FigureType::QUEEN, byColor)};
+    const Bitboard straightSliders{getFigures(FigureType::ROOK, byColor) |
+                                   getFigures(FigureType::QUEEN, byColor)};
+    return (BitboardUtils::getPawnAttacks(Color::getOppositeColor(byColor),
+                                          coordinate) &
+            getFigures(FigureType::PAWN, byColor)) ||
+           (BitboardUtils::getKnightAttacks(coordinate) &
+            getFigures(FigureType::KNIGHT, byColor)) ||
+           (BitboardUtils::getKingAttacks(coordinate) &
+            getFigures(FigureType::KING, byColor)) ||
+           (BitboardUtils::getBishopAttacks(coordinate, occupancy) &
+            diagonalSliders) ||
+           (BitboardUtils::getRookAttacks(coordinate, occupancy) &
+            straightSliders);
+}
+
+Bitboard Position::attackersTo(int coordinate, Bitboard occupancy) const {
+    const Bitboard diagonalSliders{getFigures(FigureType::BISHOP) |
+                                   getFigures(FigureType::QUEEN)};
+    const Bitboard straightSliders{getFigures(FigureType::ROOK) |
+                                   getFigures(FigureType::QUEEN)};
+    return (BitboardUtils::getPawnAttacks(Color::ColorT::WHITE, coordinate) &
+            getFigures(FigureType::PAWN, Color::ColorT::BLACK)) |
+           (BitboardUtils::getPawnAttacks(Color::ColorT::BLACK, coordinate) &
+            getFigures(FigureType::PAWN, Color::ColorT::WHITE)) |
+           (BitboardUtils::getKnightAttacks(coordinate) &
+            getFigures(FigureType::KNIGHT)) |
+           (BitboardUtils::getKingAttacks(coordinate) &
+            getFigures(FigureType::KING)) |
+           (BitboardUtils::getBishopAttacks(coordinate, occupancy) &
+            diagonalSliders) |
+           (BitboardUtils::getRookAttacks(coordinate, occupancy) &
+            straightSliders);
+}
+
+bool Position::isInCheck(Color::ColorT color) const {
+    const int kingCoordinate{getKingCoordinate(color)};
+    return kingCoordinate != -1 &&
+           isSquareAttacked(kingCoordinate, Color::getOppositeColor(color));
+}
+
+bool Position::isIrreversible(CompactMove move) const {
+    return getFigureType(move.getCoordinateFrom()) == FigureType::PAWN ||
+           (move.getFlag() != CompactMove::Flag::CASTLING &&
+            isOccupied(move.getCoordinateToMove()));
+}
@@ -0,0 +1,39 @@
+#include "search_control.h"
+
+void SearchControl::start(bool ponder) {
+    startTicks.store(
+        std::chrono::steady_clock::now().time_since_epoch().count(),
+        std::memory_order_relaxed);
+    pondering.store(ponder, std::memory_order_relaxed);
+    stop.store(false, std::memory_order_relaxed);
+}
+
+void SearchControl::requestStop() {
+    stop.store(true, std::memory_order_relaxed);
+}
+
+bool SearchControl::isStopped() const {
+    return stop.load(std::memory_order_relaxed);
+}
+
+bool SearchControl::isPondering() const {
+    return pondering.load(std::memory_order_acquire);
+}
+
+// the clock is moved before pondering ends, so no thread sees the limits
+// against the old start
+void SearchControl::ponderHit(bool restartClock) {
+    if (restartClock)
+        startTicks.store(
+            std::chrono::steady_clock::now().time_since_epoch().count(),
+            std::memory_order_relaxed);
+    pondering.store(false, std::memory_order_release);
+}
+
+std::chrono::milliseconds SearchControl::getElapsedTime() const {
+    const std::chrono::steady_clock::time_point startTime{
+        std::chrono::steady_clock::duration{
+            startTicks.load(std::memory_order_relaxed)}};
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - startTime);
+}
@@ -0,0 +1,403 @@
+#include "search_thread.h"
+#include "move_generator.h"
+#include <algorithm>
+
+SearchThread::SearchThread(int id, TranspositionTable &transpositionTable,
+                           const SearchLimits &limits, SearchControl &control,
+                           IterationCallback onIteration,
+                           const Tablebase *tablebase, const Nnue *nnue)
+    : id(id), transpositionTable(transpositionTable), limits(limits),
+      control(control), onIteration(std::move(onIteration)),
+      tablebase(tablebase), nnue(nnue) {
+    if (nnue)
+        networkPlies.resize(MAX_NETWORK_PLIES);
+}
+
+bool SearchThread::isTimeToStop() {
+    const std::uint64_t nodes{stats.nodes + stats.quiescenceNodes};
+    searchedNodes.store(nodes, std::memory_order_relaxed);
+    if (control.isStopped())
+        return true;
+    if (id || !completedDepth || control.isPondering())
+        return false;
+    bool isLimitReached{limits.maxNodes && nodes >= limits.maxNodes};
+    if (!isLimitReached && nodes % TIME_CHECK_INTERVAL == 0) {
+        const std::chrono::milliseconds budget{
+            limits.moveTime.count() ? limits.moveTime : limits.maxTime};
+        isLimitReached =
+            budget.count() && control.getElapsedTime() >= budget;
+    }
+    if (isLimitReached)
+        control.requestStop();
+    return isLimitReached;
+}
+
+bool SearchThread::isDraw(const Position &position, int ply) const {
+    if (position.getHalfmoveClock() >= FIFTY_MOVE_PLIES)
+        return true;
+    // a position can only repeat with the same side to move, at least four
+    // plies back and not before the last irreversible move
+    for (int i{ply - 4}; i >= std::max(0, ply - position.getHalfmoveClock());
+         i -= 2)
+        if (pathKeys[i] == pathKeys[ply])
+            return true;
+    return false;
+}
+
+// insertion sort, move lists are short
+void SearchThread::orderMoves(MoveList &moveList, const Position &position,
+                              CompactMove hashMove, int ply) const {
+    std::array<int, MoveList::MAX_MOVES> scores;
+    for (int i{}; i < moveList.getSize(); i++) {
+        const CompactMove move{moveList[i]};
+        const int score{scoreMove(move, position, hashMove, ply)};
+        int j{i};
+        for (; j > 0 && scores[j - 1] < score; j--) {
+            scores[j] = scores[j - 1];
+            moveList[j] = moveList[j - 1];
+        }
+        scores[j] = score;
+        moveList[j] = move;
+    }
+}
+
+int SearchThread::scoreMove(CompactMove move, const Position &position,
+                            CompactMove hashMove, int ply) const {
+    if (move == hashMove)
+        return HASH_MOVE_SCORE;
+    // a quiet promotion wins material like a capture
+    if (isCapture(move, position) ||
+        move.getFlag() == CompactMove::Flag::PROMOTION)
+        return CAPTURE_SCORE + getCaptureScore(move, position);
+    const int coordinateFrom{move.getCoordinateFrom()};
+    const int coordinateToMove{move.getCoordinateToMove()};
+    for (std::size_t i{}; i < killers[ply].size(); i++)
+        if (move == killers[ply][i])
+            return KILLER_SCORES[i];
+    return history[static_cast<int>(position.getColor(coordinateFrom))]
+                  [coordinateFrom][coordinateToMove];
+}
+
+bool SearchThread::isCapture(CompactMove move, const Position &position) {
+    return move.getFlag() == CompactMove::Flag::EN_PASSANT ||
+           (move.getFlag() != CompactMove::Flag::CASTLING &&
+            position.isOccupied(move.getCoordinateToMove()));
+}
+
+int SearchThread::getCaptureScore(CompactMove move,
+                                  const Position &position) {
+    return 100 * getVictimValue(move, position) -
+           Position::getFigureValue(
+               position.getFigureType(move.getCoordinateFrom()));
+}
+
+// the promoted figure counts as won material
+int SearchThread::getVictimValue(CompactMove move, const Position &position) {
+    int value{};
+    if (move.getFlag() == CompactMove::Flag::EN_PASSANT)
+        value = Position::getFigureValue(FigureType::PAWN);
+    else if (position.isOccupied(move.getCoordinateToMove()))
+        value = Position::getFigureValue(
+            position.getFigureType(move.getCoordinateToMove()));
+    if (move.getFlag() == CompactMove::Flag::PROMOTION)
+        value += Position::getFigureValue(move.getPromotionType()) -
+                 Position::getFigureValue(FigureType::PAWN);
+    return value;
+}
+
+void SearchThread::updateQuietCutoff(CompactMove move, Color::ColorT color,
+                                     int depth, int ply) {
+    if (move != killers[ply].front()) {
+        killers[ply].back() = killers[ply].front();
+        killers[ply].front() = move;
+    }
+    int &score{history[static_cast<int>(color)][move.getCoordinateFrom()]
+                      [move.getCoordinateToMove()]};
+    score += depth * depth;
+    if (score >= MAX_HISTORY_SCORE)
+        for (auto &fromScores : history)
+            for (auto &toScores : fromScores)
+                for (int &toScore : toScores)
+                    toScore /= 2;
+}
+
+TranspositionTable::Bound SearchThread::getBound(int score, int alpha,
+                                                 int beta) {
+    if (score <= alpha)
+        return TranspositionTable::Bound::UPPER;
+    if (score >= beta)
+        return TranspositionTable::Bound::LOWER;
+    return TranspositionTable::Bound::EXACT;
+}
+
+int SearchThread::scoreToTable(int score, int ply) {
+    if (score > MATE_BOUND)
+        return score + ply;
+    if (score < -MATE_BOUND)
+        return score - ply;
+    return score;
+}
+
+int SearchThread::scoreFromTable(int score, int ply) {
+    if (score > MATE_BOUND)
+        return score - ply;
+    if (score < -MATE_BOUND)
+        return score + ply;
+    return score;
+}
+
+int SearchThread::scoreFromTablebase(const Tablebase::Result &result,
+                                     int ply) {
+    switch (result.outcome) {
+        case Tablebase::Outcome::WIN:
+            return MATE_SCORE - ply - result.plies;
+        case Tablebase::Outcome::LOSS:
+            return -MATE_SCORE + ply + result.plies;
+        case Tablebase::Outcome::DRAW:
+            break;
+    }
+    return 0;
+}
+
+void SearchThread::pushNetworkMove(int ply, const Position &position,
+                                   CompactMove move) {
+    networkPlies[ply].changes = Nnue::getMoveChanges(position, move);
+    networkPlies[ply].isComputed = {};
+}
+
+int SearchThread::evaluateNetwork(int ply, const Position &position) {
+    Nnue::Accumulator &accumulator{networkPlies[ply].accumulator};
+    for (const Color::ColorT perspective :
+         {Color::ColorT::WHITE, Color::ColorT::BLACK}) {
+        const int side{static_cast<int>(perspective)};
+        int computedPly{ply};
+        while (!networkPlies[computedPly].isComputed[side] && computedPly &&
+               !Nnue::movesKing(networkPlies[computedPly].changes,
+                                perspective))
+            computedPly--;
+        if (!networkPlies[computedPly].isComputed[side])
+            nnue->refresh(position, perspective, accumulator);
+        else
+            for (int i{computedPly + 1}; i <= ply; i++) {
+                nnue->update(networkPlies[i - 1].accumulator,
+                             networkPlies[i].changes, perspective,
+                             position.getKingCoordinate(perspective),
+                             networkPlies[i].accumulator);
+                networkPlies[i].isComputed[side] = true;
+            }
+        networkPlies[ply].isComputed[side] = true;
+    }
+    return nnue->evaluate(accumulator, position.getSideToMove());
+}
+
+int SearchThread::evaluate(int ply, const Position &position) {
+    if (nnue)
+        return evaluateNetwork(ply, position);
+    return Evaluation::evaluate(position, pawnTable, materialTable);
+}
+
+CompactMove SearchThread::search(const Position &position) {
+    if (nnue) {
+        nnue->refresh(position, Color::ColorT::WHITE,
+                      networkPlies.front().accumulator);
+        nnue->refresh(position, Color::ColorT::BLACK,
+                      networkPlies.front().accumulator);
+        networkPlies.front().isComputed = {true, true};
+    }
+    CompactMove bestMove;
+    const int maxDepth{limits.maxDepth ? limits.maxDepth : MAX_DEPTH};
+    for (int depth{1 + id % 2}; depth <= maxDepth; depth++) {
+        if (const CompactMove move{searchRoot(depth, position)};
+            !move.isNull())
+            bestMove = move;
+        if (control.isStopped() || bestMove.isNull())
+            break;
+        completedDepth = depth;
+        if (!id && onIteration)
+            onIteration(depth, score, bestMove);
+        // the next iteration would likely not finish in the rest of the time
+        if (!id && !limits.moveTime.count() && limits.maxTime.count() &&
+            !control.isPondering() &&
+            control.getElapsedTime() * 2 >= limits.maxTime)
+            break;
+    }
+    // the helpers search until the main thread is done
+    if (!id)
+        control.requestStop();
+    stats.pawnProbes = pawnTable.getProbes();
+    stats.pawnHits = pawnTable.getHits();
+    stats.materialProbes = materialTable.getProbes();
+    stats.materialHits = materialTable.getHits();
+    return bestMove;
+}
+
+CompactMove SearchThread::searchRoot(int depth, const Position &position) {
+    const std::uint64_t key{position.getKey()};
+    pathKeys[0] = key;
+    TranspositionTable::Entry entry;
+    const CompactMove hashMove{
+        transpositionTable.probe(key, entry) ? entry.bestMove : CompactMove{}};
+    MoveList moveList;
+    MoveGenerator::generateLegalMoves(position, moveList);
+    if (!moveList.getSize())
+        score = position.isInCheck(position.getSideToMove()) ? -MATE_SCORE : 0;
+    orderMoves(moveList, position, hashMove, 0);
+    int bestScore{-INFINITE_SCORE};
+    CompactMove bestMove;
+    for (const CompactMove move : moveList) {
+        Position nextPosition{position};
+        nextPosition.makeMove(move);
+        if (nnue)
+            pushNetworkMove(1, position, move);
+        // the best score so far is the lower bound of the next moves
+        const int score{-negamax(depth - 1, 1, nextPosition, -INFINITE_SCORE,
+                                 -bestScore)};
+        if (control.isStopped())
+            break;
+        if (score > bestScore || bestMove.isNull()) {
+            bestScore = score;
+            bestMove = move;
+        }
+    }
+    if (!bestMove.isNull())
+        score = bestScore;
+    if (!bestMove.isNull() && !control.isStopped())
+        transpositionTable.store(key, depth, bestScore,
+                                 TranspositionTable::Bound::EXACT, bestMove);
+    return bestMove;
+}
+
+int SearchThread::negamax(int depth, int ply, const Position &position,
+                          int alpha, int beta) {
+    if (!depth)
+        return quiescence(ply, position, alpha, beta);
+    stats.nodes++;
+    if (isTimeToStop())
+        return 0;
+    const std::uint64_t key{position.getKey()};
+    pathKeys[ply] = key;
+    if (isDraw(position, ply))
+        return 0;
+    if (Tablebase::Result result;
+        tablebase && tablebase->probe(position, result))
+        return scoreFromTablebase(result, ply);
+    TranspositionTable::Entry entry;
+    CompactMove hashMove;
+    if (transpositionTable.probe(key, entry)) {
+        hashMove = entry.bestMove;
+        const int score{scoreFromTable(entry.score, ply)};
+        if (entry.depth >= depth &&
+            (entry.bound == TranspositionTable::Bound::EXACT ||
+             (entry.bound == TranspositionTable::Bound::LOWER &&
+              score >= beta) ||
+             (entry.bound == TranspositionTable::Bound::UPPER &&
+              score <= alpha)))
+            return score;
+    }
+    const Color::ColorT color{position.getSideToMove()};
+    MoveList moveList;
+    MoveGenerator::generateLegalMoves(position, moveList);
+    // checkmate or stalemate
+    if (!moveList.getSize())
+        return position.isInCheck(color) ? -MATE_SCORE + ply : 0;
+    orderMoves(moveList, position, hashMove, ply);
+    const int originalAlpha{alpha};
+    int bestScore{-INFINITE_SCORE};
+    CompactMove bestMove;
+    int searchedMoves{};
+    for (const CompactMove move : moveList) {
+        Position nextPosition{position};
+        nextPosition.makeMove(move);
+        if (nnue)
+            pushNetworkMove(ply + 1, position, move);
+        const int score{
+            -negamax(depth - 1, ply + 1, nextPosition, -beta, -alpha)};
+        if (control.isStopped())
+            return 0;
+        if (score > bestScore) {
+            bestScore = score;
+            bestMove = move;
+        }
+        alpha = std::max(alpha, score);
+        if (alpha >= beta) {
+            stats.cutoffs++;
+            if (!searchedMoves)
+                stats.firstMoveCutoffs++;
+            if (!isCapture(move, position))
+                updateQuietCutoff(move, color, depth, ply);
+            break;
+        }
+        searchedMoves++;
+    }
+    transpositionTable.store(key, depth, scoreToTable(bestScore, ply),
+                             getBound(bestScore, originalAlpha, beta),
+                             bestMove);
+    return bestScore;
+}
+
+int SearchThread::quiescence(int ply, const Position &position, int alpha,
+                             int beta) {
+    stats.quiescenceNodes++;
+    if (isTimeToStop())
+        return 0;
+    const int standPat{evaluate(ply, position)};
+    if (standPat >= beta)
+        return standPat;
+    alpha = std::max(alpha, standPat);
+    int bestScore{standPat};
+    MoveList moveList;
+    MoveGenerator::generateCaptures(position, moveList);
+    // captures and promotions only, so neither hash move nor killers apply
+    orderMoves(moveList, position, CompactMove{}, 0);
+    const Color::ColorT color{position.getSideToMove()};
+    for (const CompactMove move : moveList) {
+        if (standPat +
+                Evaluation::CENTIPAWNS_PER_PAWN *
+                    getVictimValue(move, position) +
+                DELTA_MARGIN <=
+            alpha)
+            continue;
+        Position nextPosition{position};
+        nextPosition.makeMove(move);
+        if (nextPosition.isInCheck(color))
+            continue;
+        if (nnue)
+            pushNetworkMove(ply + 1, position, move);
+        const int score{-quiescence(ply + 1, nextPosition, -beta, -alpha)};
+        if (control.isStopped())
+            return 0;
+        if (score > bestScore) {
+            bestScore = score;
+            if (score >= beta)
+                break;
+            alpha = std::max(alpha, score);
+        }
+    }
+    return bestScore;
+}
+
+const SearchStats &SearchThread::getStats() const {
+    return stats;
+}
+
+int SearchThread::getCompletedDepth() const {
+    return completedDepth;
+}
+
+int SearchThread::getScore() const {
+    return score;
+}
+
+std::uint64_t SearchThread::getSearchedNodes() const {
+    return searchedNodes.load(std::memory_order_relaxed);
+}
+
+bool SearchThread::isMateScore(int score) {
+    return score > MATE_BOUND || score < -MATE_BOUND;
+}
+
+// a mate in n plies scores MATE_SCORE - n, being mated -MATE_SCORE + n
+int SearchThread::getMateMoves(int score) {
+    return score > 0 ? (MATE_SCORE - score + 1) / 2
+                     : -(MATE_SCORE + score) / 2;
+}
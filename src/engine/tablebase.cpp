@@ -0,0 +1,342 @@
+#include "tablebase.h"
+#include "bitboard.h"
+#include "position.h"
+#include <algorithm>
+#include <fcntl.h>
+#include <filesystem>
+#include <optional>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <utility>
+
+const Ending::SymmetryTable Ending::SYMMETRIES = initSymmetries();
+const std::array<int, BoardUtils::NUMBER_SQUARES> Ending::TRIANGLE_INDICES =
+    initTriangleIndices();
+const std::array<int, Ending::NUMBER_TRIANGLE_SQUARES>
+    Ending::TRIANGLE_SQUARES = initTriangleSquares();
+
+Ending::SymmetryTable Ending::initSymmetries() {
+    constexpr int rowSize{BoardUtils::NUMBER_SQUARE_PER_ROW};
+    SymmetryTable symmetries{};
+    for (int symmetry{}; symmetry < NUMBER_SYMMETRIES; symmetry++)
+        for (int coordinate{}; coordinate < BoardUtils::NUMBER_SQUARES;
+             coordinate++) {
+            int row{coordinate / rowSize};
+            int file{coordinate % rowSize};
+            if (symmetry & TRANSPOSITION)
+                std::swap(row, file);
+            if (symmetry & ROW_MIRROR)
+                row = rowSize - 1 - row;
+            if (symmetry & FILE_MIRROR)
+                file = rowSize - 1 - file;
+            symmetries[symmetry][coordinate] = row * rowSize + file;
+        }
+    return symmetries;
+}
+
+// a1-d1-d4: the files a to d from the first rank up to the a1-h8 diagonal
+std::array<int, BoardUtils::NUMBER_SQUARES> Ending::initTriangleIndices() {
+    constexpr int rowSize{BoardUtils::NUMBER_SQUARE_PER_ROW};
+    std::array<int, BoardUtils::NUMBER_SQUARES> indices{};
+    indices.fill(-1);
+    int index{};
+    for (int coordinate{}; coordinate < BoardUtils::NUMBER_SQUARES;
+         coordinate++) {
+        const int rank{rowSize - 1 - coordinate / rowSize};
+        const int file{coordinate % rowSize};
+        if (file < rowSize / 2 && rank <= file)
+            indices[coordinate] = index++;
+    }
+    return indices;
+}
+
+std::array<int, Ending::NUMBER_TRIANGLE_SQUARES>
+Ending::initTriangleSquares() {
+    std::array<int, NUMBER_TRIANGLE_SQUARES> squares{};
+    for (int coordinate{}; coordinate < BoardUtils::NUMBER_SQUARES;
+         coordinate++)
+        if (TRIANGLE_INDICES[coordinate] >= 0)
+            squares[TRIANGLE_INDICES[coordinate]] = coordinate;
+    return squares;
+}
+
+Ending::Ending(std::string_view whiteFigures, std::string_view blackFigures) {
+    auto addSide{[this](std::string_view symbols, Color::ColorT color) {
+        std::array<FigureType, MAX_FIGURES> sideTypes{};
+        int size{};
+        for (const char symbol : symbols) {
+            const std::size_t type{FIGURE_SYMBOLS.find(symbol)};
+            if (type == std::string_view::npos || !type ||
+                numberFigures + size == MAX_FIGURES)
+                throw std::invalid_argument("Invalid ending");
+            sideTypes[size++] = static_cast<FigureType>(type);
+        }
+        std::sort(sideTypes.begin(), sideTypes.begin() + size);
+        for (int figure{}; figure < size; figure++) {
+            figureTypes[numberFigures] = sideTypes[figure];
+            colors[numberFigures++] = color;
+        }
+    }};
+    using enum Color::ColorT;
+    figureTypes[0] = FigureType::KING;
+    colors[0] = WHITE;
+    figureTypes[1] = FigureType::KING;
+    colors[1] = BLACK;
+    numberFigures = 2;
+    addSide(whiteFigures, WHITE);
+    addSide(blackFigures, BLACK);
+    hasPawns = getNumberPawns() > 0;
+    hasTwins = numberFigures == MAX_FIGURES &&
+               figureTypes[2] == figureTypes[3] && colors[2] == colors[3];
+}
+
+Ending Ending::fromName(std::string_view name) {
+    const std::size_t separator{name.find('v')};
+    if (separator == std::string_view::npos || !name.starts_with('K') ||
+        name.substr(separator + 1, 1) != "K")
+        throw std::invalid_argument("Invalid ending");
+    return {name.substr(1, separator - 1), name.substr(separator + 2)};
+}
+
+Ending Ending::fromPosition(const Position &position, bool &isMirrored) {
+    std::array<std::string, 2> sides;
+    for (Bitboard occupancy{position.getOccupancy()}; occupancy;) {
+        const int coordinate{BitboardUtils::popLsb(occupancy)};
+        const FigureType figureType{position.getFigureType(coordinate)};
+        if (figureType != FigureType::KING)
+            sides[static_cast<int>(position.getColor(coordinate))] +=
+                FIGURE_SYMBOLS[static_cast<int>(figureType)];
+    }
+    // a symbol earlier in FIGURE_SYMBOLS is a stronger figure
+    auto getStrength{[](char symbol) { return FIGURE_SYMBOLS.find(symbol); }};
+    for (auto &side : sides)
+        std::ranges::sort(side, {}, getStrength);
+    const std::string &white{sides[static_cast<int>(Color::ColorT::WHITE)]};
+    const std::string &black{sides[static_cast<int>(Color::ColorT::BLACK)]};
+    isMirrored = black.size() > white.size() ||
+                 (black.size() == white.size() &&
+                  std::ranges::lexicographical_compare(black, white, {},
+                                                       getStrength,
+                                                       getStrength));
+    return isMirrored ? Ending(black, white) : Ending(white, black);
+}
+
+std::string Ending::getName() const {
+    using enum Color::ColorT;
+    std::string name{"K"};
+    for (const Color::ColorT color : {WHITE, BLACK}) {
+        if (color == BLACK)
+            name += "vK";
+        for (int figure{2}; figure < numberFigures; figure++)
+            if (colors[figure] == color)
+                name += FIGURE_SYMBOLS[static_cast<int>(figureTypes[figure])];
+    }
+    return name;
+}
+
+int Ending::getNumberFigures() const {
+    return numberFigures;
+}
+
+FigureType Ending::getFigureType(int figure) const {
+    return figureTypes[figure];
+}
+
+Color::ColorT Ending::getColor(int figure) const {
+    return colors[figure];
+}
+
+bool Ending::getHasPawns() const {
+    return hasPawns;
+}
+
+int Ending::getNumberPawns() const {
+    return static_cast<int>(
+        std::count(figureTypes.begin(), figureTypes.begin() + numberFigures,
+                   FigureType::PAWN));
+}
+
+std::size_t Ending::getNumberPositions() const {
+    std::size_t positions{static_cast<std::size_t>(
+        hasPawns ? NUMBER_HALF_SQUARES : NUMBER_TRIANGLE_SQUARES)};
+    for (int figure{1}; figure < numberFigures; figure++)
+        positions *= BoardUtils::NUMBER_SQUARES;
+    return positions;
+}
+
+int Ending::getKingIndex(int coordinate) const {
+    constexpr int rowSize{BoardUtils::NUMBER_SQUARE_PER_ROW};
+    if (!hasPawns)
+        return TRIANGLE_INDICES[coordinate];
+    const int file{coordinate % rowSize};
+    return file < rowSize / 2 ? coordinate / rowSize * rowSize / 2 + file
+                              : -1;
+}
+
+int Ending::getKingCoordinate(int kingIndex) const {
+    constexpr int rowSize{BoardUtils::NUMBER_SQUARE_PER_ROW};
+    if (!hasPawns)
+        return TRIANGLE_SQUARES[kingIndex];
+    return kingIndex / (rowSize / 2) * rowSize + kingIndex % (rowSize / 2);
+}
+
+/*
+    The smallest index of the images of the position under the symmetries
+    that bring the white king to its squares. A king on the diagonal of the
+    triangle has two such images.
+*/
+std::size_t Ending::getIndex(Squares squares) const {
+    std::size_t bestIndex{SIZE_MAX};
+    for (int symmetry{}; symmetry < NUMBER_SYMMETRIES; symmetry++) {
+        // pawns allow the file mirror only
+        if (hasPawns && symmetry & ~FILE_MIRROR)
+            break;
+        const int kingIndex{getKingIndex(SYMMETRIES[symmetry][squares[0]])};
+        if (kingIndex < 0)
+            continue;
+        Squares images{};
+        for (int figure{1}; figure < numberFigures; figure++)
+            images[figure] = SYMMETRIES[symmetry][squares[figure]];
+        if (hasTwins && images[2] > images[3])
+            std::swap(images[2], images[3]);
+        std::size_t index{static_cast<std::size_t>(kingIndex)};
+        for (int figure{1}; figure < numberFigures; figure++)
+            index = index * BoardUtils::NUMBER_SQUARES + images[figure];
+        bestIndex = std::min(bestIndex, index);
+    }
+    return bestIndex;
+}
+
+Ending::Squares Ending::getSquares(std::size_t index) const {
+    Squares squares{};
+    for (int figure{numberFigures - 1}; figure > 0; figure--) {
+        squares[figure] =
+            static_cast<int>(index % BoardUtils::NUMBER_SQUARES);
+        index /= BoardUtils::NUMBER_SQUARES;
+    }
+    squares[0] = getKingCoordinate(static_cast<int>(index));
+    return squares;
+}
+
+Ending::Squares Ending::getSquares(const Position &position,
+                                   bool isMirrored) const {
+    Squares squares{};
+    Bitboard taken{};
+    for (int figure{}; figure < numberFigures; figure++) {
+        const Color::ColorT color{isMirrored
+                                      ? Color::getOppositeColor(colors[figure])
+                                      : colors[figure]};
+        const int coordinate{BitboardUtils::lsb(
+            position.getFigures(figureTypes[figure], color) & ~taken)};
+        taken |= BitboardUtils::squareBit(coordinate);
+        // mirroring the rows flips the coordinate from a8 = 0 to a1 = 0
+        squares[figure] =
+            isMirrored ? coordinate ^ (BoardUtils::NUMBER_SQUARES -
+                                       BoardUtils::NUMBER_SQUARE_PER_ROW)
+                       : coordinate;
+    }
+    return squares;
+}
+
+Position Ending::getPosition(const Squares &squares,
+                             Color::ColorT sideToMove) const {
+    Position position;
+    for (int figure{}; figure < numberFigures; figure++)
+        position.addFigure(figureTypes[figure], colors[figure],
+                           squares[figure]);
+    position.setSideToMove(sideToMove);
+    return position;
+}
+
+Tablebase::Tablebase(const std::string &directory) {
+    std::error_code error;
+    for (const auto &entry :
+         std::filesystem::directory_iterator(directory, error))
+        if (entry.path().extension() == FILE_EXTENSION)
+            addTable(entry.path().string());
+    if (error)
+        throw std::runtime_error("Cannot read " + directory);
+}
+
+Tablebase::~Tablebase() {
+    for (const auto &[name, table] : tables)
+        if (table.data)
+            munmap(const_cast<std::uint8_t *>(table.data), table.size);
+}
+
+void Tablebase::addTable(const std::string &path) {
+    const std::string name{std::filesystem::path(path).stem().string()};
+    std::optional<Ending> ending;
+    try {
+        ending = Ending::fromName(name);
+    } catch (const std::invalid_argument &ex) {
+        throw std::runtime_error(path + " is not a table");
+    }
+    const int descriptor{open(path.c_str(), O_RDONLY)};
+    if (descriptor < 0)
+        throw std::runtime_error("Cannot open " + path);
+    struct stat status {};
+    if (fstat(descriptor, &status) < 0) {
+        close(descriptor);
+        throw std::runtime_error("Cannot read " + path);
+    }
+    const std::size_t size{static_cast<std::size_t>(status.st_size)};
+    if (size != Position::NUMBER_COLORS * ending->getNumberPositions()) {
+        close(descriptor);
+        throw std::runtime_error(path + " does not fit " + name);
+    }
+    void *mapping{mmap(nullptr, size, PROT_READ, MAP_PRIVATE, descriptor, 0)};
+    close(descriptor);
+    if (mapping == MAP_FAILED)
+        throw std::runtime_error("Cannot map " + path);
+    // a probe reads one byte far from the previous one
+    madvise(mapping, size, MADV_RANDOM);
+    if (const auto table{tables.find(name)}; table != tables.end())
+        munmap(const_cast<std::uint8_t *>(table->second.data),
+               table->second.size);
+    tables.insert_or_assign(
+        name, Table{static_cast<const std::uint8_t *>(mapping), size, *ending});
+}
+
+std::size_t Tablebase::getNumberTables() const {
+    return tables.size();
+}
+
+bool Tablebase::probe(const Position &position, Result &result) const {
+    if (BitboardUtils::popCount(position.getOccupancy()) >
+            Ending::MAX_FIGURES ||
+        position.getCastlingRights())
+        return false;
+    // every pawn jump sets the square, it only counts when a pawn of the
+    // side to move can take on it
+    if (const int enPassantCoordinate{position.getEnPassantCoordinate()};
+        enPassantCoordinate >= 0 &&
+        BitboardUtils::getPawnAttacks(
+            Color::getOppositeColor(position.getSideToMove()),
+            enPassantCoordinate) &
+            position.getFigures(FigureType::PAWN, position.getSideToMove()))
+        return false;
+    bool isMirrored{};
+    const Ending ending{Ending::fromPosition(position, isMirrored)};
+    const auto table{tables.find(ending.getName())};
+    if (table == tables.end())
+        return false;
+    const Color::ColorT sideToMove{
+        isMirrored ? Color::getOppositeColor(position.getSideToMove())
+                   : position.getSideToMove()};
+    result = getResult(
+        table->second.data[static_cast<int>(sideToMove) *
+                               ending.getNumberPositions() +
+                           ending.getIndex(
+                               ending.getSquares(position, isMirrored))]);
+    return true;
+}
+
+Tablebase::Result Tablebase::getResult(std::uint8_t value) {
+    if (!value)
+        return {};
+    const int plies{value - 1};
+    return {plies % 2 ? Outcome::WIN : Outcome::LOSS, plies};
+}
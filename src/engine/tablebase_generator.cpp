@@ -0,0 +1,472 @@
+#include "tablebase_generator.h"
+#include "ai.h"
+#include "bitboard.h"
+#include "move_generator.h"
+#include "position.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <exception>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+
+TablebaseGenerator::TablebaseGenerator(const std::string &directory,
+                                       int threads)
+    : directory(directory),
+      threads(threads > 0 ? threads : AI::getDefaultThreads()) {
+}
+
+bool TablebaseGenerator::canCaptureEnPassant(const Ending &ending,
+                                             const Ending::Squares &squares,
+                                             Color::ColorT sideToMove,
+                                             int pawnCoordinate) {
+    const Color::ColorT color{Color::getOppositeColor(sideToMove)};
+    if (!(color == Color::ColorT::WHITE
+              ? BoardUtils::FOURTH_RANK
+              : BoardUtils::FIFTH_RANK)[pawnCoordinate])
+        return false;
+    Bitboard occupancy{};
+    Bitboard pawns{};
+    for (int figure{}; figure < ending.getNumberFigures(); figure++) {
+        occupancy |= BitboardUtils::squareBit(squares[figure]);
+        if (ending.getFigureType(figure) == FigureType::PAWN &&
+            ending.getColor(figure) == sideToMove)
+            pawns |= BitboardUtils::squareBit(squares[figure]);
+    }
+    const int step{-Color::getDirection(color) *
+                   BoardUtils::NUMBER_SQUARE_PER_ROW};
+    const int enPassantCoordinate{pawnCoordinate + step};
+    return !BitboardUtils::isSet(occupancy, enPassantCoordinate) &&
+           !BitboardUtils::isSet(occupancy, enPassantCoordinate + step) &&
+           (BitboardUtils::getPawnAttacks(color, enPassantCoordinate) & pawns);
+}
+
+// the same test as Tablebase::probe
+std::size_t TablebaseGenerator::getStateIndex(const Ending &ending,
+                                              const Position &position) {
+    const Color::ColorT sideToMove{position.getSideToMove()};
+    const int enPassantCoordinate{position.getEnPassantCoordinate()};
+    const bool isEnPassant{
+        enPassantCoordinate >= 0 &&
+        (BitboardUtils::getPawnAttacks(Color::getOppositeColor(sideToMove),
+                                       enPassantCoordinate) &
+         position.getFigures(FigureType::PAWN, sideToMove))};
+    return static_cast<std::size_t>(isEnPassant * Position::NUMBER_COLORS +
+                                    static_cast<int>(sideToMove)) *
+               ending.getNumberPositions() +
+           ending.getIndex(ending.getSquares(position, false));
+}
+
+template <typename Function>
+std::size_t TablebaseGenerator::runParallel(std::size_t size,
+                                            Function function) {
+    std::atomic<std::size_t> nextBlock{};
+    std::atomic<std::size_t> sum{};
+    std::exception_ptr exception;
+    std::mutex mutex;
+    {
+        std::vector<std::jthread> workers;
+        for (int worker{}; worker < threads; worker++)
+            workers.emplace_back([&] {
+                try {
+                    std::size_t workerSum{};
+                    for (std::size_t begin{nextBlock.fetch_add(BLOCK_SIZE)};
+                         begin < size; begin = nextBlock.fetch_add(BLOCK_SIZE))
+                        for (std::size_t position{begin};
+                             position < std::min(begin + BLOCK_SIZE, size);
+                             position++)
+                            workerSum += function(position);
+                    sum += workerSum;
+                } catch (...) {
+                    std::scoped_lock lock(mutex);
+                    if (!exception)
+                        exception = std::current_exception();
+                }
+            });
+    }
+    if (exception)
+        std::rethrow_exception(exception);
+    return sum;
+}
+
+/*
+    A move out of the ending that wins resolves the position at its level,
+    one that draws saves it from a loss. A position without moves within the
+    ending is resolved by its moves out of it alone.
+*/
+int TablebaseGenerator::initPosition(const Ending &ending,
+                                     std::size_t position) {
+    const std::size_t numberPositions{ending.getNumberPositions()};
+    const auto sideToMove{static_cast<Color::ColorT>(
+        position / numberPositions % Position::NUMBER_COLORS)};
+    const bool isEnPassant{position / numberPositions >=
+                           Position::NUMBER_COLORS};
+    const Ending::Squares squares{
+        ending.getSquares(position % numberPositions)};
+    counters[position] = ILLEGAL;
+    Bitboard occupancy{};
+    for (int figure{}; figure < ending.getNumberFigures(); figure++) {
+        const int coordinate{squares[figure]};
+        if (BitboardUtils::isSet(occupancy, coordinate) ||
+            (ending.getFigureType(figure) == FigureType::PAWN &&
+             (BoardUtils::EIGHTH_RANK[coordinate] ||
+              BoardUtils::FIRST_RANK[coordinate])))
+            return 0;
+        occupancy |= BitboardUtils::squareBit(coordinate);
+    }
+    if (ending.getIndex(squares) != position % numberPositions)
+        return 0;
+    Position currentPosition{ending.getPosition(squares, sideToMove)};
+    // with at most four figures both sides have one pawn at most, so the
+    // pawn that jumped is the one that can be taken
+    if (isEnPassant) {
+        for (int figure{}; figure < ending.getNumberFigures(); figure++)
+            if (ending.getFigureType(figure) == FigureType::PAWN &&
+                ending.getColor(figure) != sideToMove &&
+                canCaptureEnPassant(ending, squares, sideToMove,
+                                    squares[figure]))
+                currentPosition.setEnPassantCoordinate(
+                    squares[figure] +
+                    Color::getDirection(sideToMove) *
+                        BoardUtils::NUMBER_SQUARE_PER_ROW);
+        if (currentPosition.getEnPassantCoordinate() < 0)
+            return 0;
+    }
+    if (currentPosition.isInCheck(Color::getOppositeColor(sideToMove)))
+        return 0;
+    MoveList moveList;
+    MoveGenerator::generateLegalMoves(currentPosition, moveList);
+    if (!moveList.getSize()) {
+        counters[position] = 0;
+        if (currentPosition.isInCheck(sideToMove))
+            values[position] = 1;
+        else
+            exitLosses[position] = NO_LOSS;
+        return 0;
+    }
+    std::array<std::size_t, MoveList::MAX_MOVES> children{};
+    int numberChildren{};
+    int winLevel{};
+    int lossLevel{};
+    for (const CompactMove move : moveList) {
+        Position nextPosition{currentPosition};
+        nextPosition.makeMove(move);
+        if (!currentPosition.isOccupied(move.getCoordinateToMove()) &&
+            move.getFlag() != CompactMove::Flag::PROMOTION &&
+            move.getFlag() != CompactMove::Flag::EN_PASSANT) {
+            const std::size_t child{getStateIndex(ending, nextPosition)};
+            if (std::find(children.begin(), children.begin() + numberChildren,
+                          child) == children.begin() + numberChildren)
+                children[numberChildren++] = child;
+            continue;
+        }
+        // the kings alone cannot mate
+        Tablebase::Result result;
+        if (BitboardUtils::popCount(nextPosition.getOccupancy()) > 2 &&
+            !tablebase.probe(nextPosition, result)) {
+            bool isMirrored{};
+            throw std::runtime_error(
+                "Missing table " +
+                Ending::fromPosition(nextPosition, isMirrored).getName());
+        }
+        if (result.outcome == Tablebase::Outcome::LOSS)
+            winLevel = winLevel ? std::min(winLevel, result.plies + 1)
+                                : result.plies + 1;
+        else if (result.outcome == Tablebase::Outcome::WIN)
+            lossLevel = std::max(lossLevel, result.plies + 1);
+        else
+            exitLosses[position] = NO_LOSS;
+    }
+    counters[position] = static_cast<std::uint8_t>(numberChildren);
+    if (winLevel)
+        exitLosses[position] = NO_LOSS;
+    else if (exitLosses[position] != NO_LOSS)
+        exitLosses[position] = static_cast<std::uint8_t>(lossLevel);
+    if (std::max(winLevel, lossLevel) > Tablebase::MAX_PLIES)
+        throw std::runtime_error("Mate too long for " + ending.getName());
+    if (winLevel)
+        pendingLevels[position] = static_cast<std::uint8_t>(winLevel);
+    else if (!numberChildren && exitLosses[position] != NO_LOSS)
+        pendingLevels[position] = static_cast<std::uint8_t>(lossLevel);
+    return pendingLevels[position];
+}
+
+int TablebaseGenerator::getPredecessors(
+    const Ending &ending, const Ending::Squares &squares,
+    Color::ColorT sideToMove, bool isEnPassant,
+    std::array<std::size_t, MAX_PREDECESSORS> &predecessors) {
+    const Color::ColorT color{Color::getOppositeColor(sideToMove)};
+    const std::size_t numberPositions{ending.getNumberPositions()};
+    Bitboard occupancy{};
+    for (int figure{}; figure < ending.getNumberFigures(); figure++)
+        occupancy |= BitboardUtils::squareBit(squares[figure]);
+    int numberPredecessors{};
+    for (int figure{}; figure < ending.getNumberFigures(); figure++) {
+        const int coordinate{squares[figure]};
+        // only the pawn jump leads to a position that can take en passant
+        if (ending.getColor(figure) != color ||
+            (isEnPassant &&
+             (ending.getFigureType(figure) != FigureType::PAWN ||
+              !canCaptureEnPassant(ending, squares, sideToMove, coordinate))))
+            continue;
+        Bitboard origins{};
+        switch (ending.getFigureType(figure)) {
+            case FigureType::KING:
+                origins = BitboardUtils::getKingAttacks(coordinate);
+                break;
+            case FigureType::QUEEN:
+                origins = BitboardUtils::getQueenAttacks(coordinate, occupancy);
+                break;
+            case FigureType::ROOK:
+                origins = BitboardUtils::getRookAttacks(coordinate, occupancy);
+                break;
+            case FigureType::KNIGHT:
+                origins = BitboardUtils::getKnightAttacks(coordinate);
+                break;
+            case FigureType::BISHOP:
+                origins =
+                    BitboardUtils::getBishopAttacks(coordinate, occupancy);
+                break;
+            case FigureType::PAWN: {
+                // a pawn steps back against its direction, never to the rank
+                // of its own figures, and jumps back from its fourth rank
+                // unless the jump can be taken en passant, which leads to
+                // the en passant position instead
+                const int step{-Color::getDirection(color) *
+                               BoardUtils::NUMBER_SQUARE_PER_ROW};
+                const bool isWhite{color == Color::ColorT::WHITE};
+                const int origin{coordinate + step};
+                if (isEnPassant) {
+                    origins = BitboardUtils::squareBit(origin + step);
+                    break;
+                }
+                if ((isWhite ? BoardUtils::FIRST_RANK
+                             : BoardUtils::EIGHTH_RANK)[origin])
+                    break;
+                origins = BitboardUtils::squareBit(origin);
+                if ((isWhite ? BoardUtils::THIRD_RANK
+                             : BoardUtils::SIXTH_RANK)[origin] &&
+                    !BitboardUtils::isSet(occupancy, origin) &&
+                    !canCaptureEnPassant(ending, squares, sideToMove,
+                                         coordinate))
+                    origins |= BitboardUtils::squareBit(origin + step);
+                break;
+            }
+        }
+        for (origins &= ~occupancy; origins;) {
+            Ending::Squares previousSquares{squares};
+            previousSquares[figure] = BitboardUtils::popLsb(origins);
+            const std::size_t index{ending.getIndex(previousSquares)};
+            // the move was made from the position and, if the other side
+            // had just jumped, from its en passant position too
+            for (int block{static_cast<int>(color)};
+                 static_cast<std::size_t>(block) * numberPositions <
+                 counters.size();
+                 block += Position::NUMBER_COLORS) {
+                const std::size_t predecessor{
+                    static_cast<std::size_t>(block) * numberPositions +
+                    index};
+                if (std::atomic_ref(counters[predecessor])
+                            .load(std::memory_order_relaxed) == ILLEGAL ||
+                    std::find(predecessors.begin(),
+                              predecessors.begin() + numberPredecessors,
+                              predecessor) !=
+                        predecessors.begin() + numberPredecessors)
+                    continue;
+                predecessors[numberPredecessors++] = predecessor;
+            }
+        }
+    }
+    return numberPredecessors;
+}
+
+int TablebaseGenerator::propagate(const Ending &ending, std::size_t position,
+                                  int level) {
+    if (level + 1 > Tablebase::MAX_PLIES)
+        throw std::runtime_error("Mate too long for " + ending.getName());
+    const std::size_t numberPositions{ending.getNumberPositions()};
+    std::array<std::size_t, MAX_PREDECESSORS> predecessors{};
+    const int numberPredecessors{getPredecessors(
+        ending, ending.getSquares(position % numberPositions),
+        static_cast<Color::ColorT>(position / numberPositions %
+                                   Position::NUMBER_COLORS),
+        position / numberPositions >= Position::NUMBER_COLORS,
+        predecessors)};
+    int maxPendingLevel{};
+    for (int i{}; i < numberPredecessors; i++) {
+        const std::size_t predecessor{predecessors[i]};
+        std::atomic_ref value(values[predecessor]);
+        std::uint8_t unresolved{};
+        // the loss of the side to move is a win of the side before
+        if (!(level % 2)) {
+            value.compare_exchange_strong(
+                unresolved, static_cast<std::uint8_t>(level + 2),
+                std::memory_order_relaxed);
+            continue;
+        }
+        // the last move within the ending that did not lose
+        if (std::atomic_ref(counters[predecessor])
+                    .fetch_sub(1, std::memory_order_relaxed) != 1 ||
+            exitLosses[predecessor] == NO_LOSS)
+            continue;
+        const int lossLevel{
+            std::max(level + 1, static_cast<int>(exitLosses[predecessor]))};
+        if (lossLevel == level + 1)
+            value.compare_exchange_strong(
+                unresolved, static_cast<std::uint8_t>(level + 2),
+                std::memory_order_relaxed);
+        else {
+            std::atomic_ref(pendingLevels[predecessor])
+                .store(static_cast<std::uint8_t>(lossLevel),
+                       std::memory_order_relaxed);
+            maxPendingLevel = std::max(maxPendingLevel, lossLevel);
+        }
+    }
+    return maxPendingLevel;
+}
+
+void TablebaseGenerator::generate(const Ending &ending) {
+    const std::size_t tableSize{Position::NUMBER_COLORS *
+                                ending.getNumberPositions()};
+    std::array<bool, Position::NUMBER_COLORS> hasPawns{};
+    for (int figure{}; figure < ending.getNumberFigures(); figure++)
+        if (ending.getFigureType(figure) == FigureType::PAWN)
+            hasPawns[static_cast<int>(ending.getColor(figure))] = true;
+    const std::size_t size{hasPawns[0] && hasPawns[1] ? 2 * tableSize
+                                                      : tableSize};
+    values.assign(size, 0);
+    counters.assign(size, 0);
+    pendingLevels.assign(size, 0);
+    exitLosses.assign(size, 0);
+    std::atomic<int> maxPendingLevel{};
+    auto updateMaxPendingLevel{[&maxPendingLevel](int level) {
+        for (int current{maxPendingLevel.load()};
+             level > current &&
+             !maxPendingLevel.compare_exchange_weak(current, level);)
+            ;
+    }};
+    runParallel(size, [&](std::size_t position) {
+        updateMaxPendingLevel(initPosition(ending, position));
+        return 0;
+    });
+    // the positions resolved at a level are all lost or all won, so their
+    // predecessors at the next level never race with each other
+    for (int level{};; level++) {
+        const std::size_t resolved{
+            runParallel(size, [&](std::size_t position) -> std::size_t {
+                std::atomic_ref value(values[position]);
+                std::uint8_t current{value.load(std::memory_order_relaxed)};
+                // no pending level is 0, only mates are resolved at it
+                if (!current && level &&
+                    std::atomic_ref(pendingLevels[position])
+                            .load(std::memory_order_relaxed) == level) {
+                    current = static_cast<std::uint8_t>(level + 1);
+                    value.store(current, std::memory_order_relaxed);
+                }
+                if (current != level + 1)
+                    return 0;
+                updateMaxPendingLevel(propagate(ending, position, level));
+                return 1;
+            })};
+        if (!resolved && level >= maxPendingLevel)
+            break;
+    }
+    const std::filesystem::path path{std::filesystem::path(directory) /
+                                     (ending.getName() +
+                                      std::string(Tablebase::FILE_EXTENSION))};
+    {
+        std::ofstream file(path, std::ios::binary);
+        file.write(reinterpret_cast<const char *>(values.data()),
+                   static_cast<std::streamsize>(tableSize));
+        if (!file)
+            throw std::runtime_error("Cannot write " + path.string());
+    }
+    tablebase.addTable(path.string());
+}
+
+std::vector<Ending> TablebaseGenerator::getEndings(int maxFigures) {
+    constexpr std::string_view figures{"QRNBP"};
+    std::vector<Ending> endings;
+    for (std::size_t i{}; i < figures.size(); i++) {
+        const std::string figure(1, figures[i]);
+        if (maxFigures >= 3)
+            endings.emplace_back(figure, "");
+        if (maxFigures < 4)
+            continue;
+        for (std::size_t j{i}; j < figures.size(); j++) {
+            const std::string otherFigure(1, figures[j]);
+            endings.emplace_back(figure + otherFigure, "");
+            endings.emplace_back(figure, otherFigure);
+        }
+    }
+    // captures lead to fewer figures, promotions to fewer pawns
+    std::ranges::stable_sort(endings, {}, [](const Ending &ending) {
+        return std::pair(ending.getNumberFigures(), ending.getNumberPawns());
+    });
+    return endings;
+}
+
+int TablebaseGenerator::run(const std::vector<std::string> &arguments) {
+    std::string directory;
+    int maxFigures{Ending::MAX_FIGURES};
+    int threads{};
+    try {
+        if (arguments.size() % 2)
+            throw std::invalid_argument("missing option value");
+        for (std::size_t i{}; i < arguments.size(); i += 2) {
+            const std::string &value{arguments[i + 1]};
+            if (arguments[i] == "--output")
+                directory = value;
+            else if (arguments[i] == "--figures")
+                maxFigures = std::stoi(value);
+            else if (arguments[i] == "--threads")
+                threads = std::stoi(value);
+            else
+                throw std::invalid_argument(arguments[i]);
+        }
+        if (directory.empty() || maxFigures < 3 ||
+            maxFigures > Ending::MAX_FIGURES)
+            throw std::invalid_argument("missing output");
+    } catch (const std::logic_error &ex) {
+        std::cerr << "Usage: Chess tablebase --output <dir> [--figures <3 or "
+                     "4>] [--threads <N>]\n";
+        return 1;
+    }
+    try {
+        std::filesystem::create_directories(directory);
+        TablebaseGenerator generator(directory, threads);
+        std::size_t totalSize{};
+        long long totalMilliseconds{};
+        for (const Ending &ending : getEndings(maxFigures)) {
+            const auto start{std::chrono::steady_clock::now()};
+            generator.generate(ending);
+            const auto milliseconds{
+                std::chrono::duration_cast<std::chrono::milliseconds>(
+                    std::chrono::steady_clock::now() - start)
+                    .count()};
+            const std::size_t size{Position::NUMBER_COLORS *
+                                   ending.getNumberPositions()};
+            const int longestMate{
+                *std::max_element(generator.values.begin(),
+                                  generator.values.begin() + size) -
+                1};
+            std::cout << std::format(
+                "{}: {} KB in {} ms, longest mate {} plies\n",
+                ending.getName(), size / 1024, milliseconds,
+                std::max(longestMate, 0));
+            totalSize += size;
+            totalMilliseconds += milliseconds;
+        }
+        std::cout << std::format("Total: {} KB in {} ms\n", totalSize / 1024,
+                                 totalMilliseconds);
+    } catch (const std::exception &ex) {
+        std::cerr << ex.what() << '\n';
+        return 1;
+    }
+    return 0;
+}
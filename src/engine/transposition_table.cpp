@@ -0,0 +1,126 @@
+#include "transposition_table.h"
+#include <algorithm>
+#include <bit>
+
+static_assert(sizeof(TranspositionTable::Entry) == 16);
+static_assert(std::atomic<std::uint64_t>::is_always_lock_free);
+
+TranspositionTable::TranspositionTable(std::size_t megabytes) {
+    resize(megabytes);
+}
+
+TranspositionTable::Bucket &
+TranspositionTable::getBucket(std::uint64_t key) const {
+    return buckets[key & (bucketCount - 1)];
+}
+
+/*
+    bits  0-15  best move
+    bits 16-31  score
+    bits 32-39  depth
+    bits 40-47  bound
+    bits 48-55  generation
+*/
+std::uint64_t TranspositionTable::pack(const Entry &entry) {
+    return entry.bestMove.getData() |
+           static_cast<std::uint64_t>(static_cast<std::uint16_t>(entry.score))
+               << 16 |
+           static_cast<std::uint64_t>(static_cast<std::uint8_t>(entry.depth))
+               << 32 |
+           static_cast<std::uint64_t>(entry.bound) << 40 |
+           static_cast<std::uint64_t>(entry.generation) << 48;
+}
+
+TranspositionTable::Entry TranspositionTable::unpack(std::uint64_t key,
+                                                     std::uint64_t data) {
+    return {key,
+            CompactMove::fromData(static_cast<std::uint16_t>(data)),
+            static_cast<std::int16_t>(data >> 16),
+            static_cast<std::int8_t>(data >> 32),
+            static_cast<Bound>(data >> 40 & 0xFF),
+            static_cast<std::uint8_t>(data >> 48)};
+}
+
+void TranspositionTable::resize(std::size_t megabytes) {
+    bucketCount = std::bit_floor(
+        std::max<std::size_t>(megabytes * 1024 * 1024 / sizeof(Bucket), 1));
+    buckets = std::make_unique<Bucket[]>(bucketCount);
+    generation = 0;
+}
+
+void TranspositionTable::clear() {
+    for (std::size_t i{}; i < bucketCount; i++)
+        for (Slot &slot : buckets[i].slots) {
+            slot.keyXorData.store(0, std::memory_order_relaxed);
+            slot.data.store(0, std::memory_order_relaxed);
+        }
+    generation = 0;
+}
+
+void TranspositionTable::newSearch() {
+    generation++;
+}
+
+bool TranspositionTable::probe(std::uint64_t key, Entry &entry) const {
+    for (const Slot &slot : getBucket(key).slots) {
+        const std::uint64_t data{slot.data.load(std::memory_order_relaxed)};
+        if ((slot.keyXorData.load(std::memory_order_relaxed) ^ data) == key &&
+            data) {
+            entry = unpack(key, data);
+            return true;
+        }
+    }
+    return false;
+}
+
+/*
+    An entry of the same position is always overwritten, keeping its best
+    move when the new result has none. Otherwise the entry with the lowest
+    depth is replaced, where each search of age costs eight plies of depth.
+*/
+void TranspositionTable::store(std::uint64_t key, int depth, int score,
+                               Bound bound, CompactMove bestMove) {
+    Bucket &bucket{getBucket(key)};
+    Slot *replaced{};
+    Entry replacedEntry;
+    auto getWorth{[this](const Entry &entry) {
+        return entry.depth -
+               8 * static_cast<std::uint8_t>(generation - entry.generation);
+    }};
+    for (Slot &slot : bucket.slots) {
+        const std::uint64_t data{slot.data.load(std::memory_order_relaxed)};
+        const std::uint64_t slotKey{
+            slot.keyXorData.load(std::memory_order_relaxed) ^ data};
+        const Entry entry{unpack(slotKey, data)};
+        if (entry.bound == Bound::NONE || slotKey == key) {
+            replaced = &slot;
+            replacedEntry = entry;
+            break;
+        }
+        if (!replaced || getWorth(entry) < getWorth(replacedEntry)) {
+            replaced = &slot;
+            replacedEntry = entry;
+        }
+    }
+    if (bestMove.isNull() && replacedEntry.key == key)
+        bestMove = replacedEntry.bestMove;
+    const std::uint64_t data{pack({key, bestMove,
+                                   static_cast<std::int16_t>(score),
+                                   static_cast<std::int8_t>(depth), bound,
+                                   generation})};
+    replaced->data.store(data, std::memory_order_relaxed);
+    replaced->keyXorData.store(key ^ data, std::memory_order_relaxed);
+}
+
+int TranspositionTable::getHashfull() const {
+    const std::size_t sampled{std::min<std::size_t>(bucketCount, 1000)};
+    int used{};
+    for (std::size_t i{}; i < sampled; i++)
+        for (const Slot &slot : buckets[i].slots) {
+            const Entry entry{
+                unpack(0, slot.data.load(std::memory_order_relaxed))};
+            used += entry.bound != Bound::NONE &&
+                    entry.generation == generation;
+        }
+    return static_cast<int>(used * 1000 / (sampled * BUCKET_SIZE));
+}
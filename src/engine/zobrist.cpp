@@ -0,0 +1,39 @@
+#include "zobrist.h"
+
+// fixed seeds, so the keys are the same on every start
+const std::array<std::uint64_t, Zobrist::NUMBER_FIGURE_KEYS>
+    Zobrist::FIGURE_KEYS = initKeys<NUMBER_FIGURE_KEYS>(0x9E3779B97F4A7C15);
+const std::array<std::uint64_t, Zobrist::NUMBER_CASTLING_RIGHTS>
+    Zobrist::CASTLING_KEYS = initCastlingKeys(0xD1B54A32D192ED03);
+const std::array<std::uint64_t, BoardUtils::NUMBER_SQUARE_PER_ROW>
+    Zobrist::EN_PASSANT_KEYS =
+        initKeys<BoardUtils::NUMBER_SQUARE_PER_ROW>(0x8CB92BA72F3D8DD7);
+const std::uint64_t Zobrist::SIDE_KEY = initKeys<1>(0xABC98388FB8FAC03)[0];
+
+// splitmix64
+std::uint64_t Zobrist::nextRandom(std::uint64_t &seed) {
+    std::uint64_t random{seed += 0x9E3779B97F4A7C15};
+    random = (random ^ (random >> 30)) * 0xBF58476D1CE4E5B9;
+    random = (random ^ (random >> 27)) * 0x94D049BB133111EB;
+    return random ^ (random >> 31);
+}
+
+template <std::size_t N>
+std::array<std::uint64_t, N> Zobrist::initKeys(std::uint64_t seed) {
+    std::array<std::uint64_t, N> keys{};
+    for (auto &key : keys)
+        key = nextRandom(seed);
+    return keys;
+}
+
+std::array<std::uint64_t, Zobrist::NUMBER_CASTLING_RIGHTS>
+Zobrist::initCastlingKeys(std::uint64_t seed) {
+    const std::array<std::uint64_t, 4> rightKeys{initKeys<4>(seed)};
+    std::array<std::uint64_t, NUMBER_CASTLING_RIGHTS> keys{};
+    for (int castlingRights{}; castlingRights < NUMBER_CASTLING_RIGHTS;
+         castlingRights++)
+        for (int right{}; right < 4; right++)
+            if (castlingRights & (1 << right))
+                keys[castlingRights] ^= rightKeys[right];
+    return keys;
+}
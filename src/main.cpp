@@ -1,12 +1,87 @@
+#include "analyzer.h"
 #include "board.h"
 #include "cli.h"
 #include "figure.h"
 #include "move.h"
+#include "nnue.h"
+#include "opening_book.h"
+#include "perft.h"
 #include "player.h"
+#include "tablebase.h"
+#include "tablebase_generator.h"
+#include "uci.h"
 #include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
 
-int main() {
-    auto table(std::make_unique<Table>());
+int main(int argc, char *argv[]) {
+    const std::vector<std::string> arguments(argv + 1, argv + argc);
+    if (!arguments.empty() && arguments.front() == "perft")
+        return Perft::run({arguments.begin() + 1, arguments.end()});
+    if (!arguments.empty() && arguments.front() == "analyze")
+        return Analyzer::run({arguments.begin() + 1, arguments.end()});
+    if (!arguments.empty() && arguments.front() == "tablebase")
+        return TablebaseGenerator::run(
+            {arguments.begin() + 1, arguments.end()});
+    if (arguments.size() == 1 && arguments.front() == "uci") {
+        Uci().run();
+        return 0;
+    }
+    std::size_t hashMegabytes{TranspositionTable::DEFAULT_MEGABYTES};
+    int threads{};
+    std::string bookPath;
+    OpeningBook::Selection bookSelection{OpeningBook::Selection::WEIGHTED};
+    std::string tablebaseDirectory;
+    std::string networkPath;
+    try {
+        if (arguments.size() % 2)
+            throw std::invalid_argument("missing option value");
+        for (std::size_t i{}; i < arguments.size(); i += 2) {
+            if (arguments[i] == "--hash")
+                hashMegabytes = std::stoul(arguments[i + 1]);
+            else if (arguments[i] == "--threads")
+                threads = std::stoi(arguments[i + 1]);
+            else if (arguments[i] == "--book")
+                bookPath = arguments[i + 1];
+            else if (arguments[i] == "--book-selection" &&
+                     arguments[i + 1] == "best")
+                bookSelection = OpeningBook::Selection::BEST;
+            else if (arguments[i] == "--book-selection" &&
+                     arguments[i + 1] == "weighted")
+                bookSelection = OpeningBook::Selection::WEIGHTED;
+            else if (arguments[i] == "--tablebases")
+                tablebaseDirectory = arguments[i + 1];
+            else if (arguments[i] == "--nnue")
+                networkPath = arguments[i + 1];
+            else
+                throw std::invalid_argument("unknown option");
+        }
+    } catch (const std::logic_error &ex) {
+        std::cerr << "Usage: Chess [--hash <MB>] [--threads <N>] [--book "
+                     "<file>] [--book-selection weighted|best] [--tablebases "
+                     "<dir>] [--nnue <file>]\n";
+        return 1;
+    }
+    std::unique_ptr<OpeningBook> openingBook;
+    std::unique_ptr<Tablebase> tablebase;
+    std::unique_ptr<Nnue> network;
+    try {
+        if (!bookPath.empty())
+            openingBook =
+                std::make_unique<OpeningBook>(bookPath, bookSelection);
+        if (!tablebaseDirectory.empty())
+            tablebase = std::make_unique<Tablebase>(tablebaseDirectory);
+        if (!networkPath.empty())
+            network = std::make_unique<Nnue>(networkPath);
+    } catch (const std::runtime_error &ex) {
+        std::cerr << ex.what() << '\n';
+        return 1;
+    }
+    auto table(std::make_unique<Table>(hashMegabytes, threads,
+                                       std::move(openingBook),
+                                       std::move(tablebase),
+                                       std::move(network)));
     table->startGame();
     std::cin.get();
     return 0;
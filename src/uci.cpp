@@ -0,0 +1,285 @@
+#include "uci.h"
+#include "fen.h"
+#include "move_generator.h"
+#include "search_thread.h"
+#include "tablebase.h"
+#include <algorithm>
+#include <format>
+#include <iostream>
+#include <stdexcept>
+
+Uci::Uci() {
+    createAi();
+    Fen::parse(Fen::START_POSITION, position);
+}
+
+void Uci::setPosition(std::istringstream &tokens) {
+    std::string token;
+    std::string fen;
+    tokens >> token;
+    if (token == "startpos") {
+        fen = Fen::START_POSITION;
+        tokens >> token;
+    } else if (token == "fen") {
+        while (tokens >> token && token != "moves")
+            fen += token + ' ';
+    } else {
+        return;
+    }
+    Position newPosition;
+    try {
+        Fen::parse(fen, newPosition);
+    } catch (const std::invalid_argument &ex) {
+        send(std::format("info string {}", ex.what()));
+        return;
+    }
+    if (token == "moves")
+        while (tokens >> token) {
+            const CompactMove move{parseMove(newPosition, token)};
+            if (move.isNull()) {
+                send(std::format("info string Illegal move {}", token));
+                break;
+            }
+            newPosition.makeMove(move);
+        }
+    position = newPosition;
+}
+
+/*
+    A clock without a move time is shared out over the moves to go, plus half
+    of the increment. The search does not start a new iteration after half
+    of it and stops when it is used up.
+*/
+void Uci::go(std::istringstream &tokens) {
+    stop();
+    SearchLimits limits;
+    std::chrono::milliseconds::rep whiteTime{};
+    std::chrono::milliseconds::rep blackTime{};
+    std::chrono::milliseconds::rep whiteIncrement{};
+    std::chrono::milliseconds::rep blackIncrement{};
+    std::chrono::milliseconds::rep moveTime{};
+    int movesToGo{};
+    bool isPondering{};
+    bool isInfiniteSearch{};
+    for (std::string token; tokens >> token;) {
+        if (token == "depth")
+            tokens >> limits.maxDepth;
+        else if (token == "nodes")
+            tokens >> limits.maxNodes;
+        else if (token == "movetime")
+            tokens >> moveTime;
+        else if (token == "wtime")
+            tokens >> whiteTime;
+        else if (token == "btime")
+            tokens >> blackTime;
+        else if (token == "winc")
+            tokens >> whiteIncrement;
+        else if (token == "binc")
+            tokens >> blackIncrement;
+        else if (token == "movestogo")
+            tokens >> movesToGo;
+        else if (token == "infinite")
+            isInfiniteSearch = true;
+        else if (token == "ponder")
+            isPondering = true;
+    }
+    limits.moveTime = std::chrono::milliseconds{moveTime};
+    limits.maxDepth = std::clamp(limits.maxDepth, 0, SearchThread::MAX_DEPTH);
+    const bool isWhite{position.getSideToMove() == Color::ColorT::WHITE};
+    const std::chrono::milliseconds remainingTime{isWhite ? whiteTime
+                                                          : blackTime};
+    const std::chrono::milliseconds increment{isWhite ? whiteIncrement
+                                                      : blackIncrement};
+    if (remainingTime.count() && !moveTime)
+        limits.maxTime = std::max(
+            std::chrono::milliseconds{1},
+            std::min(remainingTime /
+                             (movesToGo > 0 ? movesToGo : DEFAULT_MOVES_TO_GO) +
+                         increment / 2,
+                     remainingTime - MOVE_OVERHEAD));
+    {
+        std::scoped_lock lock(mutex);
+        isInfinite = isInfiniteSearch;
+        isStopRequested = false;
+    }
+    control.start(isPondering);
+    searcher = std::jthread([this, rootPosition = position, limits] {
+        search(rootPosition, limits);
+    });
+}
+
+// setoption name <name> value <value>, the bot is rebuilt with the new size
+// or given the new tables
+void Uci::setOption(std::istringstream &tokens) {
+    std::string token;
+    std::string name;
+    std::string value;
+    tokens >> token;
+    while (tokens >> token && token != "value")
+        name += name.empty() ? token : ' ' + token;
+    // a path may hold spaces
+    std::getline(tokens >> std::ws, value);
+    if (value.empty()) {
+        send(std::format("info string Missing value of {}", name));
+        return;
+    }
+    // only a hint that ponder commands may follow, nothing to change
+    if (name == "Ponder")
+        return;
+    if (name == "TablebasePath") {
+        std::unique_ptr<Tablebase> tablebase;
+        try {
+            if (value != EMPTY_VALUE)
+                tablebase = std::make_unique<Tablebase>(value);
+        } catch (const std::runtime_error &ex) {
+            send(std::format("info string {}", ex.what()));
+            return;
+        }
+        stop();
+        tablebasePath = tablebase ? value : "";
+        if (tablebase)
+            send(std::format("info string Found {} tables",
+                             tablebase->getNumberTables()));
+        ai->setTablebase(std::move(tablebase));
+        return;
+    }
+    try {
+        if (name == "Hash")
+            hashMegabytes = std::clamp(std::stoi(value), 1, MAX_HASH_MEGABYTES);
+        else if (name == "Threads")
+            threads = std::clamp(std::stoi(value), 1, MAX_THREADS);
+        else {
+            send(std::format("info string Unknown option {}", name));
+            return;
+        }
+    } catch (const std::logic_error &ex) {
+        send(std::format("info string Invalid value of {}", name));
+        return;
+    }
+    stop();
+    createAi();
+}
+
+// the tables are mapped again, they were found when the path was set
+void Uci::createAi() {
+    ai = std::make_unique<AI>(hashMegabytes, threads);
+    if (tablebasePath.empty())
+        return;
+    try {
+        ai->setTablebase(std::make_unique<Tablebase>(tablebasePath));
+    } catch (const std::runtime_error &ex) {
+        send(std::format("info string {}", ex.what()));
+        tablebasePath.clear();
+    }
+}
+
+void Uci::search(const Position &rootPosition, const SearchLimits &limits) {
+    const CompactMove bestMove{
+        ai->search(rootPosition, limits, control,
+                   [this](const SearchInfo &info) { sendInfo(info); })};
+    const std::vector<CompactMove> principalVariation{
+        ai->getPrincipalVariation(rootPosition, bestMove)};
+    {
+        std::unique_lock lock(mutex);
+        bestMoveReleased.wait(lock, [this] {
+            return isStopRequested || (!isInfinite && !control.isPondering());
+        });
+    }
+    if (bestMove.isNull())
+        send("bestmove 0000");
+    else if (principalVariation.size() > 1)
+        send(std::format("bestmove {} ponder {}", bestMove.toString(),
+                         principalVariation[1].toString()));
+    else
+        send(std::format("bestmove {}", bestMove.toString()));
+}
+
+void Uci::stop() {
+    {
+        std::scoped_lock lock(mutex);
+        isStopRequested = true;
+        control.requestStop();
+    }
+    bestMoveReleased.notify_all();
+    if (searcher.joinable())
+        searcher.join();
+}
+
+void Uci::ponderHit() {
+    {
+        std::scoped_lock lock(mutex);
+        control.ponderHit();
+    }
+    bestMoveReleased.notify_all();
+}
+
+void Uci::sendInfo(const SearchInfo &info) {
+    std::string line{std::format(
+        "info depth {} score {} nodes {} nps {} hashfull {} time {} pv",
+        info.depth, formatScore(info.score), info.nodes,
+        info.nodes * 1000 / std::max<std::uint64_t>(info.time.count(), 1),
+        info.hashfull, info.time.count())};
+    for (const CompactMove move : info.principalVariation)
+        line += ' ' + move.toString();
+    send(line);
+}
+
+void Uci::send(const std::string &line) {
+    std::scoped_lock lock(mutex);
+    std::cout << line << std::endl;
+}
+
+CompactMove Uci::parseMove(const Position &position, const std::string &name) {
+    MoveList moveList;
+    MoveGenerator::generateLegalMoves(position, moveList);
+    for (const CompactMove move : moveList)
+        if (move.toString() == name)
+            return move;
+    return {};
+}
+
+std::string Uci::formatScore(int score) {
+    if (SearchThread::isMateScore(score))
+        return std::format("mate {}", SearchThread::getMateMoves(score));
+    return std::format("cp {}", score);
+}
+
+void Uci::run() {
+    for (std::string line; std::getline(std::cin, line);) {
+        std::istringstream tokens(line);
+        std::string command;
+        tokens >> command;
+        if (command == "uci") {
+            send(std::format("id name {}", ENGINE_NAME));
+            send(std::format("option name Hash type spin default {} min 1 "
+                             "max {}",
+                             TranspositionTable::DEFAULT_MEGABYTES,
+                             MAX_HASH_MEGABYTES));
+            send(std::format(
+                "option name Threads type spin default 1 min 1 max {}",
+                MAX_THREADS));
+            send("option name Ponder type check default false");
+            send(std::format("option name TablebasePath type string default {}",
+                             EMPTY_VALUE));
+            send("uciok");
+        } else if (command == "isready") {
+            send("readyok");
+        } else if (command == "ucinewgame") {
+            stop();
+            ai->clear();
+        } else if (command == "position") {
+            setPosition(tokens);
+        } else if (command == "go") {
+            go(tokens);
+        } else if (command == "stop") {
+            stop();
+        } else if (command == "ponderhit") {
+            ponderHit();
+        } else if (command == "setoption") {
+            setOption(tokens);
+        } else if (command == "quit") {
+            break;
+        }
+    }
+    stop();
+}